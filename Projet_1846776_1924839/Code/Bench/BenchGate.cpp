@@ -0,0 +1,288 @@
+// Performance regression gate, see BenchGate.h.
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../NuanceurProg.h"
+#include "../SeaBench.h"
+#include "../SeaCdlod.h"
+#include "../SeaClipmap.h"
+#include "../SeaTess.h"
+#include "../SurfaceNode.h"
+#include "../Var.h"
+#include "BenchGate.h"
+#include "GlStub.h"
+
+// camera paths of the gate, also flown by the application with --benchmark:
+// a fly-over, a flight close to the water and a still view from a corner
+static const char* gatePaths[]     = { "survol", "rasant", "fixe" };
+static const char* rendererNames[] = { "tess", "cdlod", "clipmap" };
+
+struct GateMetric
+{
+    std::string config; // path/renderer
+    std::string name;
+    double      value;
+    double      tolerance;
+};
+
+/// Matrices of refreshCamera() for a camera of the path.
+static void setPathCamera(const SeaBenchCamera& camera)
+{
+    float     h = camera.horizontalAngle, v = camera.verticalAngle;
+    glm::vec3 direction(std::cos(v) * std::sin(h), std::sin(v), std::cos(v) * std::cos(h));
+    glm::vec3 right(std::sin(h - 3.14f / 2.0f), 0.0f, std::cos(h - 3.14f / 2.0f));
+    CVar::projection = glm::perspective(glm::radians(45.0f), float(SEA_BENCH_WIDTH) / SEA_BENCH_HEIGHT, 0.1f, 2000.0f);
+    CVar::vue        = glm::lookAt(camera.position, camera.position + direction, glm::cross(right, direction));
+}
+
+/// Nearest rank percentile of sorted values.
+static double percentile(const std::vector<double>& sorted, double rank)
+{
+    size_t i = static_cast<size_t>(std::ceil(rank * sorted.size()));
+    return sorted[std::max<size_t>(i, 1) - 1];
+}
+
+/// Flies the current path with a renderer and adds its metrics.
+static void flyPath(const std::string& config, CNuanceurProg& prog, std::vector<GateMetric>& metrics)
+{
+    typedef std::chrono::steady_clock clock;
+    int                 frames = static_cast<int>(seaBenchDuration() / SEA_BENCH_DT) + 1;
+    std::vector<double> best(frames, 1e30);
+    long                glCalls = 0, draws = 0, patches = 0;
+
+    for (int run = 0; run < BENCH_GATE_RUNS; run++)
+    {
+        // warm up at the start of the path, then one frame per step
+        for (int i = -SEA_BENCH_WARMUP; i < frames; i++)
+        {
+            double         t      = std::max(i, 0) * SEA_BENCH_DT;
+            SeaBenchCamera camera = seaBenchCamera(t);
+            CVar::temps           = t;
+            setPathCamera(camera);
+
+            long              calls0 = glStubCalls, draws0 = glStubDraws;
+            clock::time_point t0     = clock::now();
+            if (CVar::seaRenderer == SEA_RENDER_CDLOD)
+            {
+                createTree(0, 0, 0, BENCH_GATE_TREE_SIZE, BENCH_GATE_TREE_SIZE, camera.position);
+                renderSeaCdlod(prog, camera.position);
+            }
+            else if (CVar::seaRenderer == SEA_RENDER_CLIPMAP)
+                renderSeaClipmap(prog, camera.position);
+            else
+            {
+                createTree(0, 0, 0, BENCH_GATE_TREE_SIZE, BENCH_GATE_TREE_SIZE, camera.position);
+                renderSea(prog, camera.position);
+            }
+            double us = std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+
+            if (i < 0)
+                continue;
+            best[i] = std::min(best[i], us);
+            if (run == 0)
+            {
+                glCalls += glStubCalls - calls0;
+                draws += glStubDraws - draws0;
+                patches += CVar::seaRenderer == SEA_RENDER_CLIPMAP ? seaClipmapBlocks() : surfacePatchesDrawn();
+            }
+        }
+    }
+
+    std::sort(best.begin(), best.end());
+    const GateMetric values[] = {
+        { config, "frame_p50_us", percentile(best, 0.5), BENCH_GATE_TIME_TOLERANCE },
+        { config, "frame_p95_us", percentile(best, 0.95), BENCH_GATE_TIME_TOLERANCE },
+        { config, "frame_p99_us", percentile(best, 0.99), BENCH_GATE_TIME_TOLERANCE },
+        { config, "draw_calls", double(draws) / frames, BENCH_GATE_COUNT_TOLERANCE },
+        { config, "gl_calls", double(glCalls) / frames, BENCH_GATE_COUNT_TOLERANCE },
+        { config, "patches", double(patches) / frames, BENCH_GATE_COUNT_TOLERANCE },
+    };
+    metrics.insert(metrics.end(), values, values + sizeof(values) / sizeof(values[0]));
+}
+
+/// Every path with every renderer. False when a path can't be read.
+static bool flyAll(std::vector<GateMetric>& metrics)
+{
+    CVar::waveSize     = BENCH_GATE_WAVE_SIZE;
+    CVar::lodBias      = BENCH_GATE_LOD_BIAS;
+    CVar::tessScale    = 1.0f;
+    CVar::lodAuto      = false;
+    CVar::lodMotion    = false;
+    CVar::foveation    = false;
+    CVar::seaSkirts    = false;
+    CVar::isSeaGrid    = false;
+    CVar::mouseControl = false;
+
+    surfaceInit();
+    seaTessInit();
+    seaCdlodInit();
+    seaClipmapInit();
+    CNuanceurProg prog;
+
+    bool ok = true;
+    for (size_t p = 0; p < sizeof(gatePaths) / sizeof(gatePaths[0]) && ok; p++)
+    {
+        ok = seaBenchLoadPath(("Chemins/" + std::string(gatePaths[p]) + ".txt").c_str());
+        for (int r = 0; r < 3 && ok; r++)
+        {
+            CVar::seaRenderer = r;
+            flyPath(std::string(gatePaths[p]) + "/" + rendererNames[r], prog, metrics);
+        }
+    }
+    CVar::seaRenderer = SEA_RENDER_TESS;
+
+    seaClipmapShutdown();
+    seaCdlodShutdown();
+    seaTessShutdown();
+    surfaceShutdown();
+    return ok;
+}
+
+static bool isTime(const GateMetric& m)
+{
+    return m.name.compare(0, 6, "frame_") == 0;
+}
+
+static bool readBaseline(const char* path, std::vector<GateMetric>& metrics)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "Impossible d'ouvrir la référence %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    int  number = 0;
+    bool ok     = true;
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        number++;
+        // comments, empty lines and the header
+        char first = ' ';
+        if (sscanf(line, " %c", &first) != 1 || first == '#' || strncmp(line, "config,", 7) == 0)
+            continue;
+
+        char       config[64], name[64];
+        GateMetric m;
+        if (sscanf(line, "%63[^,],%63[^,],%lf,%lf", config, name, &m.value, &m.tolerance) != 4)
+        {
+            fprintf(stderr, "%s:%d: ligne invalide\n", path, number);
+            ok = false;
+            break;
+        }
+        m.config = config;
+        m.name   = name;
+        metrics.push_back(m);
+    }
+    fclose(file);
+    return ok;
+}
+
+int benchGateWrite(const char* baseline, bool times)
+{
+    std::vector<GateMetric> flown, metrics;
+    if (!flyAll(flown))
+        return 2;
+    for (size_t i = 0; i < flown.size(); i++)
+    {
+        if (isTime(flown[i]) != times)
+            continue;
+        if (times && flown[i].value < BENCH_GATE_TIME_FLOOR_US)
+        {
+            printf("%s %s: %.2f us, sous le plancher de bruit, pas écrit\n", flown[i].config.c_str(),
+                   flown[i].name.c_str(), flown[i].value);
+            continue;
+        }
+        metrics.push_back(flown[i]);
+    }
+
+    FILE* file = fopen(baseline, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Impossible d'écrire %s\n", baseline);
+        return 2;
+    }
+    if (times)
+    {
+        fprintf(file, "# Frame times of the perf gate (Bench/BenchGate.h) on one machine, written by:\n");
+        fprintf(file, "#     bench --write-time-baseline <file>\n");
+    }
+    else
+        fprintf(file, "# Counts of the perf gate (Bench/BenchGate.h), written by: bench --write-baseline <file>\n");
+    fprintf(file, "# waveSize %d, lodBias %.2f, tree %.0f m, step %.4f s, %d frames of warm-up\n",
+            BENCH_GATE_WAVE_SIZE, BENCH_GATE_LOD_BIAS, BENCH_GATE_TREE_SIZE, SEA_BENCH_DT, SEA_BENCH_WARMUP);
+    fprintf(file, "config,metric,value,tolerance\n");
+    for (size_t i = 0; i < metrics.size(); i++)
+    {
+        fprintf(file, "%s,%s,%.2f,%.2f\n", metrics[i].config.c_str(), metrics[i].name.c_str(), metrics[i].value,
+                metrics[i].tolerance);
+    }
+    fclose(file);
+    printf("Référence écrite dans %s (%u mesures)\n", baseline, static_cast<unsigned>(metrics.size()));
+    return 0;
+}
+
+int benchGateCheck(const char* baseline)
+{
+    std::vector<GateMetric> reference, current;
+    if (!readBaseline(baseline, reference) || !flyAll(current))
+        return 2;
+
+#ifdef NDEBUG
+    const bool compareTimes = true;
+#else
+    const bool compareTimes = false;
+    printf("Build non optimisé: les temps sont affichés mais pas comparés\n");
+#endif
+
+    int regressions = 0;
+    printf("%-16s %-14s %12s %12s %9s\n", "config", "metric", "baseline", "current", "change");
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        const GateMetric& ref = reference[i];
+        const GateMetric* cur = NULL;
+        for (size_t j = 0; j < current.size() && !cur; j++)
+        {
+            if (current[j].config == ref.config && current[j].name == ref.name)
+                cur = &current[j];
+        }
+        if (!cur)
+        {
+            printf("%-16s %-14s %12.2f %12s %9s  ABSENTE\n", ref.config.c_str(), ref.name.c_str(), ref.value, "-",
+                   "-");
+            regressions++;
+            continue;
+        }
+
+        // the baseline holds two decimals
+        double      value   = std::floor(cur->value * 100.0 + 0.5) / 100.0;
+        double      change  = ref.value > 0.0 ? value / ref.value - 1.0 : (value > 0.0 ? 1.0 : 0.0);
+        bool        noise   = isTime(ref) && std::fabs(value - ref.value) <= BENCH_GATE_TIME_FLOOR_US;
+        const char* verdict = "";
+        if ((!isTime(ref) || compareTimes) && !noise)
+        {
+            if (change > ref.tolerance)
+            {
+                verdict = "REGRESSION";
+                regressions++;
+            }
+            else if (change < -ref.tolerance)
+                verdict = "meilleur, mettre la référence à jour";
+        }
+        printf("%-16s %-14s %12.2f %12.2f %+8.1f%%  %s\n", ref.config.c_str(), ref.name.c_str(), ref.value, value,
+               change * 100.0, verdict);
+    }
+
+    if (regressions)
+        printf("%d mesure(s) au-dessus de la tolérance de %s\n", regressions, baseline);
+    else
+        printf("Aucune régression par rapport à %s\n", baseline);
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+// Performance regression gate (ctest -R perf_gate): the camera paths of
+// Chemins/ are flown with every sea renderer on the GL stubs, with fixed
+// scene settings, and the frames are checked against a stored baseline.
+//
+// Metrics, per path and renderer:
+//     frame_p50_us, frame_p95_us, frame_p99_us   CPU time of a frame
+//     draw_calls, gl_calls, patches              per frame, mean
+// Counts don't depend on the machine and get a tight tolerance: they are
+// the checked-in baseline, Bench/perf_baseline.csv. Times are the fastest of
+// BENCH_GATE_RUNS flights of each frame and only mean something on the
+// machine that measured them: they go to a separate baseline of that
+// machine (SEA_PERF_TIME_BASELINE in CMake). Times are only compared in
+// optimized builds (NDEBUG), which the CMake bench target always is.
+//
+// Baselines, CSV with # comments, counts or times or both:
+//     config,metric,value,tolerance
+// A metric fails when it is more than tolerance (relative) above its value,
+// and times also by more than BENCH_GATE_TIME_FLOOR_US.
+// Everything is lower-is-better.
+
+// flights of every path, the fastest time of each frame is kept
+#define BENCH_GATE_RUNS 9
+// allowed relative increase, written to new baselines
+#define BENCH_GATE_TIME_TOLERANCE 0.25
+#define BENCH_GATE_COUNT_TOLERANCE 0.02
+// smaller time increases (us) are noise, whatever the tolerance
+#define BENCH_GATE_TIME_FLOOR_US 5.0
+// fixed scene settings
+#define BENCH_GATE_WAVE_SIZE 2
+#define BENCH_GATE_LOD_BIAS 2.5f
+#define BENCH_GATE_TREE_SIZE 1000.0f
+
+/**
+* Flies the paths and compares them with baseline: prints every metric with
+* its change and returns 0 when none regressed, 1 otherwise, 2 when the
+* paths or the baseline can't be read.
+*/
+int benchGateCheck(const char* baseline);
+
+/**
+* Flies the paths and writes a new baseline with the default tolerances:
+* the counts, or with times the frame times. Times under
+* BENCH_GATE_TIME_FLOOR_US are left out, they could never fail.
+*/
+int benchGateWrite(const char* baseline, bool times);
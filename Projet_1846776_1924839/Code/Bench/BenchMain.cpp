@@ -0,0 +1,177 @@
+// Microbenchmarks of the CPU hot paths, without a window: the GL calls of
+// the sea code go to the no-op stubs of GlStub.cpp.
+//
+// Prints one CSV line per benchmark on stdout, to diff between commits:
+//     name,iterations,median_ns,min_ns,items
+// median_ns and min_ns are per iteration, over BENCH_BATCHES batches of
+// `iterations` iterations each; items is the work done by one iteration
+// (nodes, points, bytes...). Run from the directory holding Textures/ and
+// Nuanceurs/, like the application. An argument only runs the benchmarks
+// whose name contains it. The CMake target is always optimized (-O2,
+// NDEBUG), whatever CMAKE_BUILD_TYPE is.
+//
+// --gate <baseline>, --write-baseline <baseline> (counts) and
+// --write-time-baseline <baseline> (frame times of this machine) run the
+// perf gate of BenchGate.h instead, --test [name] the checks of
+// BenchTests.h.
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../NuanceurProg.h"
+#include "../SeaNoise.h"
+#include "../SurfaceNode.h"
+#include "../TextureAbstraite.h"
+#include "../Var.h"
+#include "../textfile.h"
+#include "BenchGate.h"
+#include "BenchTests.h"
+
+// time a batch should last at least, in seconds
+#define BENCH_BATCH_SECONDS 0.05
+#define BENCH_BATCHES 7
+
+// Camera positions over the 1000 x 1000 sea, from close to the surface to high above
+static const glm::vec3 benchCameras[] = {
+    glm::vec3(0.0f, 0.0f, 0.0f),       glm::vec3(250.0f, 5.0f, -120.0f), glm::vec3(-400.0f, 30.0f, 400.0f),
+    glm::vec3(480.0f, 2.0f, 480.0f),   glm::vec3(0.0f, 150.0f, 0.0f),    glm::vec3(-200.0f, 60.0f, -350.0f),
+};
+static const int benchCameraCount = sizeof(benchCameras) / sizeof(benchCameras[0]);
+
+/// Access to the BMP loader of the textures, without a GL texture.
+class BenchTexture : public CTextureAbstraite
+{
+public:
+    BenchTexture() : CTextureAbstraite(GL_TEXTURE_2D, false, false) {}
+    int load(const std::string& nomFichier, Image* image) { return loadBMP(nomFichier, image); }
+
+protected:
+    void chargerTexture() {}
+};
+
+/// Matrices of refreshCamera() for a camera looking down the +z axis, tilted down.
+static void setCamera(const glm::vec3& position)
+{
+    glm::vec3 direction = glm::normalize(glm::vec3(0.3f, -0.35f, 1.0f));
+    CVar::projection    = glm::perspective(glm::radians(45.0f), 1280.0f / 720.0f, 0.1f, 2000.0f);
+    CVar::vue           = glm::lookAt(position, position + direction, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+/// Runs body in batches long enough to time and prints the CSV line.
+static void run(const char* filter, const char* name, long items, const std::function<void()>& body)
+{
+    if (filter && !strstr(name, filter))
+        return;
+
+    typedef std::chrono::steady_clock clock;
+    long iterations = 1;
+    for (;;)
+    {
+        clock::time_point t0 = clock::now();
+        for (long i = 0; i < iterations; i++)
+            body();
+        if (std::chrono::duration<double>(clock::now() - t0).count() >= BENCH_BATCH_SECONDS)
+            break;
+        iterations *= 2;
+    }
+
+    std::vector<double> ns;
+    for (int b = 0; b < BENCH_BATCHES; b++)
+    {
+        clock::time_point t0 = clock::now();
+        for (long i = 0; i < iterations; i++)
+            body();
+        ns.push_back(std::chrono::duration<double, std::nano>(clock::now() - t0).count() / iterations);
+    }
+    std::sort(ns.begin(), ns.end());
+    printf("%s,%ld,%.1f,%.1f,%ld\n", name, iterations, ns[BENCH_BATCHES / 2], ns[0], items);
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 2 && strcmp(argv[1], "--gate") == 0)
+        return benchGateCheck(argv[2]);
+    if (argc > 2 && strcmp(argv[1], "--write-baseline") == 0)
+        return benchGateWrite(argv[2], false);
+    if (argc > 2 && strcmp(argv[1], "--write-time-baseline") == 0)
+        return benchGateWrite(argv[2], true);
+    if (argc > 1 && strcmp(argv[1], "--test") == 0)
+        return benchTestsRun(argc > 2 ? argv[2] : NULL);
+
+    const char* filter = argc > 1 ? argv[1] : NULL;
+    CVar::lodAuto      = false;
+    CVar::lodMotion    = false;
+    surfaceInit();
+
+    printf("name,iterations,median_ns,min_ns,items\n");
+
+    // quadtree built from every camera: createTree() and its divideNode() recursion
+    long leaves = 0;
+    for (int c = 0; c < benchCameraCount; c++)
+    {
+        setCamera(benchCameras[c]);
+        createTree(0, 0, 0, 1000, 1000, benchCameras[c]);
+        leaves += surfaceTessLevels();
+    }
+    run(filter, "createTree", leaves, [] {
+        for (int c = 0; c < benchCameraCount; c++)
+        {
+            setCamera(benchCameras[c]);
+            createTree(0, 0, 0, 1000, 1000, benchCameras[c]);
+        }
+    });
+
+    // the rest on the tree of the camera close to the surface
+    setCamera(benchCameras[1]);
+    createTree(0, 0, 0, 1000, 1000, benchCameras[1]);
+    int treeLeaves = surfaceTessLevels();
+
+    // every split node has four children
+    long nodes = 1 + 4 * surfaceSubdivisions(benchCameras[1]);
+    run(filter, "needsSubdivision", nodes, [] {
+        volatile int split = surfaceSubdivisions(benchCameras[1]);
+        (void)split;
+    });
+
+    std::vector<glm::vec2> points;
+    for (int i = 0; i < 4096; i++)
+        points.push_back(glm::vec2(float(i % 64) * 15.6f - 495.0f, float(i / 64) * 15.6f - 495.0f));
+    run(filter, "find", static_cast<long>(points.size()), [&points] {
+        volatile float width = 0.0f;
+        for (size_t i = 0; i < points.size(); i++)
+            width = width + surfaceLeafWidth(points[i].x, points[i].y);
+    });
+
+    run(filter, "calcTessLevels", treeLeaves, [] { surfaceTessLevels(); });
+
+    // CPU wave heights and normals, as queried by the application
+    std::vector<float>     heights(points.size());
+    std::vector<glm::vec3> normals(points.size());
+    run(filter, "seaNoiseEvaluate", static_cast<long>(points.size()), [&] {
+        seaNoiseEvaluate(points.data(), points.size(), 1234.5f, 2.0f, heights.data(), normals.data());
+    });
+
+    // files of the application
+    BenchTexture texture;
+    Image        image;
+    texture.load("Textures/gazon.bmp", &image);
+    run(filter, "loadBMP", static_cast<long>(image.data.size()), [&texture] {
+        Image bmp;
+        texture.load("Textures/gazon.bmp", &bmp);
+    });
+
+    long glslBytes = static_cast<long>(textFileRead("Nuanceurs/seaSurface.glsl").size());
+    run(filter, "textFileRead", glslBytes, [] {
+        volatile size_t size = textFileRead("Nuanceurs/seaSurface.glsl").size();
+        (void)size;
+    });
+
+    surfaceShutdown();
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Checks of the sea code, see BenchTests.h.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "../SeaMemory.h"
+#include "../SeaReplay.h"
+#include "../Var.h"
+#include "BenchTests.h"
+
+// failed conditions of the running check
+static int testFailures = 0;
+
+#define TEST_CHECK(condition) testCheck(condition, #condition, __FILE__, __LINE__)
+
+static void testCheck(bool ok, const char* condition, const char* file, int line)
+{
+    if (ok)
+        return;
+    printf("  %s:%d: %s\n", file, line, condition);
+    testFailures++;
+}
+
+/// Sizes, peaks, objects and the churn of a frame through the registry. The
+/// GL stubs don't name objects: the names are filled in beforehand.
+static void testMemory()
+{
+    SeaMemStats before = seaMemStats(SeaMemBuffers);
+    seaMemFrame();
+
+    GLuint buffers[2] = { 7, 0 };
+    seaMemGenBuffers(SeaMemBuffers, 2, buffers);
+    seaMemBufferData(buffers[0], GL_ARRAY_BUFFER, 1000, NULL, GL_STREAM_DRAW);
+    seaMemBufferData(buffers[1], GL_ARRAY_BUFFER, 500, NULL, GL_STREAM_DRAW);
+    seaMemFrame();
+    SeaMemStats s = seaMemStats(SeaMemBuffers);
+    // name 0 is not tracked
+    TEST_CHECK(s.bytes == before.bytes + 1000);
+    TEST_CHECK(s.objects == before.objects + 1);
+    TEST_CHECK(s.frameChurn == 1000);
+    TEST_CHECK(s.frameOps == 1);
+
+    // orphaning at the same size, every frame
+    for (int frame = 0; frame < 3; frame++)
+    {
+        seaMemBufferData(buffers[0], GL_ARRAY_BUFFER, 1000, NULL, GL_STREAM_DRAW);
+        seaMemFrame();
+        s = seaMemStats(SeaMemBuffers);
+        TEST_CHECK(s.bytes == before.bytes + 1000);
+        TEST_CHECK(s.frameChurn == 0);
+        TEST_CHECK(s.frameOps == 0);
+    }
+
+    // growing: the old storage is released, the new one created
+    seaMemBufferData(buffers[0], GL_ARRAY_BUFFER, 3000, NULL, GL_STREAM_DRAW);
+    seaMemFrame();
+    s = seaMemStats(SeaMemBuffers);
+    TEST_CHECK(s.bytes == before.bytes + 3000);
+    TEST_CHECK(s.peak >= s.bytes);
+    TEST_CHECK(s.frameChurn == 4000);
+
+    seaMemDeleteBuffers(1, buffers);
+    seaMemFrame();
+    s = seaMemStats(SeaMemBuffers);
+    TEST_CHECK(s.bytes == before.bytes);
+    TEST_CHECK(s.objects == before.objects);
+    TEST_CHECK(s.peak >= before.bytes + 3000);
+    TEST_CHECK(s.frameChurn == 3000);
+    TEST_CHECK(s.frameOps == 1);
+
+    // CPU blocks
+    SeaMemStats nodes = seaMemStats(SeaMemTreeNodes);
+    void*       block = seaMemMalloc(SeaMemTreeNodes, 256);
+    TEST_CHECK(block != NULL);
+    TEST_CHECK(seaMemStats(SeaMemTreeNodes).bytes == nodes.bytes + 256);
+    seaMemFree(block);
+    seaMemFrame();
+    s = seaMemStats(SeaMemTreeNodes);
+    TEST_CHECK(s.bytes == nodes.bytes);
+    TEST_CHECK(s.objects == nodes.objects);
+    TEST_CHECK(s.frameChurn == 512);
+    TEST_CHECK(s.frameOps == 2);
+    TEST_CHECK(seaMemFrameChurn() == 512);
+}
+
+// recording of testReplay(), in the working directory
+#define TEST_REPLAY_FILE "bench_test_replay.sear"
+
+struct TestKeyEvent
+{
+    int key, scancode, action, mods;
+};
+
+// events dispatched by the replay
+static std::vector<TestKeyEvent> replayedEvents;
+
+static void replayKeyboard(GLFWwindow*, int key, int scancode, int action, int mods)
+{
+    if (!seaReplayKeyEvent(key, scancode, action, mods))
+        return;
+    TestKeyEvent event = { key, scancode, action, mods };
+    replayedEvents.push_back(event);
+}
+
+/// Events of frame f of testReplay(): none, one, then more than a frame
+/// used to hold.
+static int replayEventCount(int f)
+{
+    static const int counts[] = { 0, 1, 40, 3 };
+    return counts[f];
+}
+
+/// Records frames through the input filters, replays them and compares:
+/// time, mouse, polled keys, CVar values and every key event in order.
+static void testReplay()
+{
+    const int frames    = 4;
+    float     tessScale = CVar::tessScale, lodBias = CVar::lodBias;
+
+    TEST_CHECK(seaReplayRecord(TEST_REPLAY_FILE));
+    for (int f = 0; f < frames; f++)
+    {
+        CVar::tessScale = 1.0f + 0.25f * f;
+        CVar::lodBias   = 2.5f + f;
+        TEST_CHECK(seaReplayBeginFrame());
+        seaReplayTime(0.5 * f);
+        double dx = 3.0 * f, dy = -1.0 * f;
+        seaReplayMouse(dx, dy);
+        seaReplayKey(GLFW_KEY_W, f % 2 ? GLFW_PRESS : GLFW_RELEASE);
+        seaReplayKey(GLFW_KEY_D, GLFW_PRESS);
+        for (int e = 0; e < replayEventCount(f); e++)
+            TEST_CHECK(seaReplayKeyEvent(GLFW_KEY_A + e % 26, 30 + e, e % 3, f));
+        seaReplayEndFrame(NULL, replayKeyboard);
+    }
+    seaReplayShutdown();
+
+    CVar::tessScale = tessScale;
+    CVar::lodBias   = lodBias;
+    TEST_CHECK(seaReplayOpen(TEST_REPLAY_FILE));
+    for (int f = 0; f < frames; f++)
+    {
+        TEST_CHECK(seaReplayBeginFrame());
+        TEST_CHECK(CVar::tessScale == 1.0f + 0.25f * f);
+        TEST_CHECK(CVar::lodBias == 2.5f + f);
+        TEST_CHECK(seaReplayTime(-1.0) == 0.5 * f);
+        double dx = 0.0, dy = 0.0;
+        seaReplayMouse(dx, dy);
+        TEST_CHECK(dx == 3.0 * f && dy == -1.0 * f);
+        TEST_CHECK(seaReplayKey(GLFW_KEY_W, GLFW_RELEASE) == (f % 2 ? GLFW_PRESS : GLFW_RELEASE));
+        TEST_CHECK(seaReplayKey(GLFW_KEY_D, GLFW_RELEASE) == GLFW_PRESS);
+        TEST_CHECK(seaReplayKey(GLFW_KEY_S, GLFW_RELEASE) == GLFW_RELEASE);
+
+        // live events are dropped, the recorded ones dispatched
+        TEST_CHECK(!seaReplayKeyEvent(GLFW_KEY_Q, 0, GLFW_PRESS, 0));
+        replayedEvents.clear();
+        seaReplayEndFrame(NULL, replayKeyboard);
+        TEST_CHECK(static_cast<int>(replayedEvents.size()) == replayEventCount(f));
+        for (size_t e = 0; e < replayedEvents.size(); e++)
+        {
+            const TestKeyEvent& event = replayedEvents[e];
+            int                 i     = static_cast<int>(e);
+            TEST_CHECK(event.key == GLFW_KEY_A + i % 26 && event.scancode == 30 + i);
+            TEST_CHECK(event.action == i % 3 && event.mods == f);
+        }
+    }
+    TEST_CHECK(!seaReplayBeginFrame());
+    seaReplayShutdown();
+
+    CVar::tessScale = tessScale;
+    CVar::lodBias   = lodBias;
+    remove(TEST_REPLAY_FILE);
+}
+
+struct BenchTest
+{
+    const char* name;
+    void (*run)();
+};
+
+static const BenchTest benchTests[] = {
+    { "memory", testMemory },
+    { "replay", testReplay },
+};
+
+int benchTestsRun(const char* filter)
+{
+    int failed = 0;
+    for (size_t i = 0; i < sizeof(benchTests) / sizeof(benchTests[0]); i++)
+    {
+        if (filter && !strstr(benchTests[i].name, filter))
+            continue;
+        testFailures = 0;
+        benchTests[i].run();
+        printf("%-12s %s\n", benchTests[i].name, testFailures ? "ECHEC" : "ok");
+        failed += testFailures ? 1 : 0;
+    }
+    return failed ? 1 : 0;
+}
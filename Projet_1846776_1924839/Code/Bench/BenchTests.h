@@ -0,0 +1,13 @@
+#pragma once
+// Checks of the sea code that need no GL context (ctest -R bench_test),
+// run by bench --test [name]: each one prints its failed conditions and
+// its verdict.
+//
+//     memory   accounting of the SeaMemory.h registry
+//     replay   record and replay round trip of SeaReplay.h
+
+/**
+* Runs the checks whose name contains filter, every check without one.
+* Returns 0 when they all pass, 1 otherwise.
+*/
+int benchTestsRun(const char* filter);
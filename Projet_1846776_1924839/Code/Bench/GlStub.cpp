@@ -0,0 +1,109 @@
+// No-op OpenGL for the benchmarks (BenchMain.cpp): the GLEW entry points and
+// the OpenGL 1.1 functions reached by the sea code, so it runs without a
+// context. Every call is counted, does nothing and returns 0. A link error
+// on a missing __glewXxx means a new GL call: add it to the list.
+
+#include <GL/glew.h>
+
+#include "GlStub.h"
+
+long glStubCalls = 0;
+long glStubDraws = 0;
+
+/// Stub of a GLEW function pointer type: ignores its arguments, returns R().
+template <typename T>
+struct GlStub;
+
+template <typename R, typename... A>
+struct GlStub<R(GLAPIENTRY*)(A...)>
+{
+    static R GLAPIENTRY call(A...)
+    {
+        glStubCalls++;
+        return R();
+    }
+    static R GLAPIENTRY draw(A...)
+    {
+        glStubCalls++;
+        glStubDraws++;
+        return R();
+    }
+};
+
+#define GL_STUB(type, name) type __glew##name = &GlStub<type>::call;
+#define GL_DRAW_STUB(type, name) type __glew##name = &GlStub<type>::draw;
+
+GL_STUB(PFNGLACTIVETEXTUREPROC, ActiveTexture)
+GL_STUB(PFNGLATTACHSHADERPROC, AttachShader)
+GL_STUB(PFNGLBEGINQUERYPROC, BeginQuery)
+GL_STUB(PFNGLBINDBUFFERPROC, BindBuffer)
+GL_STUB(PFNGLBINDBUFFERBASEPROC, BindBufferBase)
+GL_STUB(PFNGLBINDFRAMEBUFFERPROC, BindFramebuffer)
+GL_STUB(PFNGLBINDRENDERBUFFERPROC, BindRenderbuffer)
+GL_STUB(PFNGLBINDVERTEXARRAYPROC, BindVertexArray)
+GL_STUB(PFNGLBUFFERDATAPROC, BufferData)
+GL_STUB(PFNGLBUFFERSUBDATAPROC, BufferSubData)
+GL_STUB(PFNGLCHECKFRAMEBUFFERSTATUSPROC, CheckFramebufferStatus)
+GL_STUB(PFNGLCOMPILESHADERPROC, CompileShader)
+GL_STUB(PFNGLCREATEPROGRAMPROC, CreateProgram)
+GL_STUB(PFNGLCREATESHADERPROC, CreateShader)
+GL_STUB(PFNGLDELETEBUFFERSPROC, DeleteBuffers)
+GL_STUB(PFNGLDELETEFRAMEBUFFERSPROC, DeleteFramebuffers)
+GL_STUB(PFNGLDELETEQUERIESPROC, DeleteQueries)
+GL_STUB(PFNGLDELETERENDERBUFFERSPROC, DeleteRenderbuffers)
+GL_STUB(PFNGLDELETEVERTEXARRAYSPROC, DeleteVertexArrays)
+GL_DRAW_STUB(PFNGLDRAWELEMENTSINSTANCEDPROC, DrawElementsInstanced)
+GL_STUB(PFNGLENABLEVERTEXATTRIBARRAYPROC, EnableVertexAttribArray)
+GL_STUB(PFNGLENDQUERYPROC, EndQuery)
+GL_STUB(PFNGLFRAMEBUFFERRENDERBUFFERPROC, FramebufferRenderbuffer)
+GL_STUB(PFNGLFRAMEBUFFERTEXTURE2DPROC, FramebufferTexture2D)
+GL_STUB(PFNGLGENBUFFERSPROC, GenBuffers)
+GL_STUB(PFNGLGENFRAMEBUFFERSPROC, GenFramebuffers)
+GL_STUB(PFNGLGENQUERIESPROC, GenQueries)
+GL_STUB(PFNGLGENRENDERBUFFERSPROC, GenRenderbuffers)
+GL_STUB(PFNGLGENVERTEXARRAYSPROC, GenVertexArrays)
+GL_STUB(PFNGLGETINTEGER64VPROC, GetInteger64v)
+GL_STUB(PFNGLGETPROGRAMINFOLOGPROC, GetProgramInfoLog)
+GL_STUB(PFNGLGETPROGRAMIVPROC, GetProgramiv)
+GL_STUB(PFNGLGETQUERYOBJECTIVPROC, GetQueryObjectiv)
+GL_STUB(PFNGLGETQUERYOBJECTUI64VPROC, GetQueryObjectui64v)
+GL_STUB(PFNGLGETSHADERINFOLOGPROC, GetShaderInfoLog)
+GL_STUB(PFNGLGETSHADERIVPROC, GetShaderiv)
+GL_STUB(PFNGLGETUNIFORMLOCATIONPROC, GetUniformLocation)
+GL_STUB(PFNGLLINKPROGRAMPROC, LinkProgram)
+GL_STUB(PFNGLPATCHPARAMETERIPROC, PatchParameteri)
+GL_STUB(PFNGLQUERYCOUNTERPROC, QueryCounter)
+GL_STUB(PFNGLRENDERBUFFERSTORAGEPROC, RenderbufferStorage)
+GL_STUB(PFNGLSHADERSOURCEPROC, ShaderSource)
+GL_STUB(PFNGLTEXSTORAGE2DPROC, TexStorage2D)
+GL_STUB(PFNGLUNIFORM1FPROC, Uniform1f)
+GL_STUB(PFNGLUNIFORM1IPROC, Uniform1i)
+GL_STUB(PFNGLUNIFORM1UIPROC, Uniform1ui)
+GL_STUB(PFNGLUNIFORM2FPROC, Uniform2f)
+GL_STUB(PFNGLUNIFORM3FVPROC, Uniform3fv)
+GL_STUB(PFNGLUNIFORMMATRIX3FVPROC, UniformMatrix3fv)
+GL_STUB(PFNGLUNIFORMMATRIX4FVPROC, UniformMatrix4fv)
+GL_STUB(PFNGLUSEPROGRAMPROC, UseProgram)
+GL_STUB(PFNGLVERTEXATTRIBDIVISORPROC, VertexAttribDivisor)
+GL_STUB(PFNGLVERTEXATTRIBPOINTERPROC, VertexAttribPointer)
+
+// OpenGL 1.1, exported by the GL library itself
+extern "C"
+{
+void GLAPIENTRY glBindTexture(GLenum, GLuint) { glStubCalls++; }
+void GLAPIENTRY glDeleteTextures(GLsizei, const GLuint*) { glStubCalls++; }
+void GLAPIENTRY glDisable(GLenum) { glStubCalls++; }
+void GLAPIENTRY glDrawElements(GLenum, GLsizei, GLenum, const void*) { glStubCalls++; glStubDraws++; }
+void GLAPIENTRY glEnable(GLenum) { glStubCalls++; }
+void GLAPIENTRY glFinish() { glStubCalls++; }
+void GLAPIENTRY glGenTextures(GLsizei, GLuint*) { glStubCalls++; }
+void GLAPIENTRY glGetFloatv(GLenum, GLfloat* params) { glStubCalls++; *params = 0.0f; }
+const GLubyte* GLAPIENTRY glGetString(GLenum)
+{
+    glStubCalls++;
+    return reinterpret_cast<const GLubyte*>("stub");
+}
+void GLAPIENTRY glPolygonMode(GLenum, GLenum) { glStubCalls++; }
+void GLAPIENTRY glTexParameterf(GLenum, GLenum, GLfloat) { glStubCalls++; }
+void GLAPIENTRY glTexParameteri(GLenum, GLenum, GLint) { glStubCalls++; }
+}
@@ -0,0 +1,7 @@
+#pragma once
+// Counters of the no-op OpenGL of GlStub.cpp, read by the perf gate (BenchGate.h).
+
+/// Every GL call since the start.
+extern long glStubCalls;
+/// glDrawElements() and glDrawElementsInstanced() calls since the start.
+extern long glStubDraws;
@@ -21,6 +21,9 @@ const float CCst::freqRotZ = 0.2f;
 
 const float CCst::frameRate = 50.0f;
 
+const double CCst::pasSimulation    = 1.0 / 60.0;
+const int    CCst::pasSimulationMax = 8;
+
 const int CCst::nbLumieresOpenGL = 3;
 
 const float CCst::largeurModele  = 20.0f;
@@ -135,6 +135,11 @@ public:
     /// le framerate cible de l'application graphique.
     static const float frameRate;
 
+    /// pas fixe de la simulation (caméra, temps des vagues), en secondes
+    static const double pasSimulation;
+    /// pas rattrapés au plus par image, au-delà la simulation ralentit
+    static const int pasSimulationMax;
+
     /// le nombre de lumières openGL de la scène
     static const int nbLumieresOpenGL;
 
@@ -91,6 +91,30 @@ CNuanceurProg::CNuanceurProg(const std::string& nuanceurSommetsStr, const std::s
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+///  global public overloaded  CNuanceurProg \n
+///
+///  Constructeur utilisé pour construire un programme de calcul (compute shader)
+///  ne comportant qu'un seul nuanceur.
+///
+///  @param [in]  nuanceurCalculStr std::string  Nom de fichier du nuanceur de calcul
+///  @param [in]  compilerMaintenant bool        Indique si l'on doit compiler le nuanceur à la construction de l'objet
+///
+///////////////////////////////////////////////////////////////////////////////
+CNuanceurProg::CNuanceurProg(const std::string& nuanceurCalculStr, const bool compilerMaintenant)
+    : nuanceurCalculStr_(nuanceurCalculStr)
+    , estCompileEtLie_(false)
+{
+    assert(!nuanceurCalculStr_.empty());
+
+    estVide_ = false;
+
+    if (compilerMaintenant)
+    {
+        compilerEtLierCalcul(nuanceurCalculStr);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///  global public  compilerEtLier \n
 ///
@@ -110,6 +134,12 @@ void CNuanceurProg::compilerEtLier()
     // vérifie si le programme en cours est un programme de nuanceurs
     assert(!estVide_);
 
+    if (!nuanceurCalculStr_.empty())
+    {
+        compilerEtLierCalcul(nuanceurCalculStr_);
+        return;
+    }
+
     compilerEtLierNuanceurs(nuanceurSommetsStr_, nuanceurFragmentsStr_, nuanceurTessCtrlStr_, nuanceurTessEvalStr_);
 
 }
@@ -279,7 +309,7 @@ void CNuanceurProg::compilerEtLierNuanceurs(const std::string& nsStr, const std:
         nuanceurSommets = glCreateShader(GL_VERTEX_SHADER);
 
         // lecture du code du nuanceur
-        const auto ns = textFileRead(nsStr);
+        const auto ns = lireNuanceur(nsStr);
 
         // créer un pointeur sur le texte du code du nuanceur
         const char* ns_ptr = ns.c_str();
@@ -301,7 +331,7 @@ void CNuanceurProg::compilerEtLierNuanceurs(const std::string& nsStr, const std:
         nuanceurTessCtrl = glCreateShader( GL_TESS_CONTROL_SHADER );
 
         // lecture du code du nuanceur
-        const auto ntc = textFileRead( ntcStr );
+        const auto ntc = lireNuanceur( ntcStr );
 
         // créer un pointeur sur le texte du code du nuanceur
         const char* ntc_ptr = ntc.c_str();
@@ -323,7 +353,7 @@ void CNuanceurProg::compilerEtLierNuanceurs(const std::string& nsStr, const std:
         nuanceurTessEval = glCreateShader( GL_TESS_EVALUATION_SHADER );
 
         // lecture du code du nuanceur
-        const auto nte = textFileRead( nteStr );
+        const auto nte = lireNuanceur( nteStr );
 
         // créer un pointeur sur le texte du code du nuanceur
         const char* nte_ptr = nte.c_str();
@@ -345,7 +375,7 @@ void CNuanceurProg::compilerEtLierNuanceurs(const std::string& nsStr, const std:
         nuanceurFragments = glCreateShader(GL_FRAGMENT_SHADER);
 
         // lecture du code du nuanceur
-        const auto nf = textFileRead(nfStr);
+        const auto nf = lireNuanceur(nfStr);
 
         // créer un pointeur sur le texte du code du nuanceur
         const char* nf_ptr = nf.c_str();
@@ -393,7 +423,7 @@ void CNuanceurProg::compilerEtLierNuanceurs(const std::string& nsStr, const std:
         nuanceurSommets = glCreateShader(GL_VERTEX_SHADER);
 
         // lecture du code du nuanceur
-        const auto ns = textFileRead(nsStr);
+        const auto ns = lireNuanceur(nsStr);
 
         // créer un pointeur sur le texte du code du nuanceur
         const char* ns_ptr = ns.c_str();
@@ -415,7 +445,7 @@ void CNuanceurProg::compilerEtLierNuanceurs(const std::string& nsStr, const std:
         nuanceurFragments = glCreateShader(GL_FRAGMENT_SHADER);
 
         // lecture du code du nuanceur
-        const auto nf = textFileRead(nfStr);
+        const auto nf = lireNuanceur(nfStr);
 
         // créer un pointeur sur le texte du code du nuanceur
         const char* nf_ptr = nf.c_str();
@@ -440,7 +470,157 @@ void CNuanceurProg::compilerEtLierNuanceurs(const std::string& nsStr, const std:
     estCompileEtLie_ = true;
 }
 
+void CNuanceurProg::compilerEtLierCalcul(const std::string& ncStr)
+{
+    // indiquer la progression...
+    printf("Compilation du nuanceur de calcul    : %s \n", ncStr.c_str());
+
+    // créer le nuanceur en GLSL
+    GLuint nuanceurCalcul = glCreateShader(GL_COMPUTE_SHADER);
+
+    // lecture du code du nuanceur
+    const auto nc = lireNuanceur(ncStr);
+
+    // créer un pointeur sur le texte du code du nuanceur
+    const char* nc_ptr = nc.c_str();
+
+    // sourcer le nuanceur
+    glShaderSource(nuanceurCalcul, 1, &nc_ptr, nullptr);
+
+    glCompileShader(nuanceurCalcul);
+    afficherShaderInfoLog(nuanceurCalcul, "ERREURS DE COMPILATION DU NUANCEUR DE CALCUL : ");
+
+    // créer le programme et lier
+    prog_ = glCreateProgram();
+    glAttachShader(prog_, nuanceurCalcul);
+    glLinkProgram(prog_);
+
+    // afficher les erreurs de compilation et de linkage
+    afficherProgramInfoLog(prog_, "ERREURS DE L'EDITION DES LIENS : ");
+
+    // marquer le nuanceur compilé
+    estCompileEtLie_ = true;
+}
+
 GLuint CNuanceurProg::getProg()
 {
     return prog_;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+///  public  definir \n
+///
+///  Ajoute une définition de préprocesseur à tous les nuanceurs du programme.
+///  Permet de choisir des variantes à la compilation sans dupliquer les fichiers.
+///
+///  @param [in]  nom std::string       le nom de la macro
+///  @param [in]  valeur std::string    sa valeur
+///
+///  @return Aucune
+///
+///////////////////////////////////////////////////////////////////////////////
+void CNuanceurProg::definir(const std::string& nom, const std::string& valeur)
+{
+    definitions_ += "#define " + nom + " " + valeur + "\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///  private  lireNuanceur \n
+///
+///  Lit le code d'un nuanceur. Les #include sont développés et les définitions
+///  sont insérées juste après la ligne #version, qui doit rester la première
+///  du nuanceur.
+///
+///  @param [in]  nomFichier std::string    le nom de fichier du nuanceur
+///
+///  @return std::string le code du nuanceur
+///
+///////////////////////////////////////////////////////////////////////////////
+std::string CNuanceurProg::lireNuanceur(const std::string& nomFichier)
+{
+    size_t      separateur = nomFichier.find_last_of("/\\");
+    std::string dossier    = separateur == std::string::npos ? "" : nomFichier.substr(0, separateur + 1);
+
+    std::string code = developperInclusions(textFileRead(nomFichier), dossier, 0);
+    if (definitions_.empty())
+    {
+        return code;
+    }
+
+    size_t debut   = 0;
+    size_t version = code.find("#version");
+    if (version != std::string::npos)
+    {
+        debut = code.find('\n', version);
+        if (debut == std::string::npos)
+        {
+            code += "\n";
+            debut = code.size();
+        }
+        else
+        {
+            debut++;
+        }
+    }
+
+    return code.insert(debut, definitions_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///  private  developperInclusions \n
+///
+///  Remplace chaque ligne #include "fichier" par le contenu du fichier, lu
+///  relativement au dossier du nuanceur. Permet de partager du code GLSL
+///  (ex. : le bruit des vagues) entre plusieurs nuanceurs.
+///
+///  @param [in]  code std::string       le code du nuanceur
+///  @param [in]  dossier std::string    le dossier du nuanceur
+///  @param [in]  profondeur int         le niveau d'inclusion courant
+///
+///  @return std::string le code avec les inclusions développées
+///
+///////////////////////////////////////////////////////////////////////////////
+std::string CNuanceurProg::developperInclusions(const std::string& code, const std::string& dossier, int profondeur)
+{
+    // protection contre les inclusions circulaires
+    if (profondeur > 8)
+    {
+        printf("Trop d'inclusions imbriquees dans %s\n", dossier.c_str());
+        return code;
+    }
+
+    std::string resultat;
+    size_t      debut = 0;
+    while (debut < code.size())
+    {
+        size_t fin = code.find('\n', debut);
+        if (fin == std::string::npos)
+        {
+            fin = code.size();
+        }
+        std::string ligne = code.substr(debut, fin - debut);
+
+        size_t directive = ligne.find_first_not_of(" \t");
+        size_t guillemet = ligne.find('"');
+        size_t dernier   = ligne.find_last_of('"');
+        if (directive != std::string::npos && ligne.compare(directive, 8, "#include") == 0 &&
+            guillemet != std::string::npos && dernier > guillemet)
+        {
+            std::string nomFichier = dossier + ligne.substr(guillemet + 1, dernier - guillemet - 1);
+            std::string inclus     = textFileRead(nomFichier);
+            if (inclus.empty())
+            {
+                printf("Fichier inclus introuvable : %s\n", nomFichier.c_str());
+            }
+            resultat += developperInclusions(inclus, dossier, profondeur + 1);
+        }
+        else
+        {
+            resultat += ligne;
+        }
+        resultat += "\n";
+        debut = fin + 1;
+    }
+
+    return resultat;
+}
@@ -81,6 +81,8 @@ public:
     /// constructeur spécifique : utilisé pour créer un PROGRAMME DE NUANCEURS.
     CNuanceurProg(const std::string& nuanceurSommetsStr, const std::string& nuanceurFragmentsStr,
                   const bool compilerImmediatement);
+    /// constructeur spécifique : utilisé pour créer un PROGRAMME DE CALCUL (compute shader).
+    CNuanceurProg(const std::string& nuanceurCalculStr, const bool compilerImmediatement);
 
     /// compile et lie dans openGL les nuanceurs du programme
     void compilerEtLier();
@@ -103,6 +105,9 @@ public:
     /// Retourne l'identificateur du programme de nuanceurs pour utiliser externe spécifique
     GLuint getProg();
 
+    /// Ajoute un "#define nom valeur" aux nuanceurs (à appeler avant la compilation)
+    void definir(const std::string& nom, const std::string& valeur);
+
 private:
     /// Compile et lie les nuanceurs définis à la construction
     void compilerEtLierNuanceurs(const std::string& nsStr, const std::string& nfStr);
@@ -115,6 +120,18 @@ private:
 
     void compilerEtLierNuanceurs( const std::string& nsStr, const std::string& nfStr, const std::string& ntcStr, const std::string& nteStr );
 
+    /// Compile et lie un programme de calcul (compute shader)
+    void compilerEtLierCalcul(const std::string& ncStr);
+
+    /// Lit le code d'un nuanceur et y insère les définitions après la ligne #version
+    std::string lireNuanceur(const std::string& nomFichier);
+
+    /// Remplace les lignes #include "fichier" par le contenu du fichier
+    std::string developperInclusions(const std::string& code, const std::string& dossier, int profondeur);
+
+    /// les lignes "#define" ajoutées à chacun des nuanceurs
+    std::string definitions_;
+
     /// la chaîne de caractères du nom de fichier du nuanceur de sommets
     std::string nuanceurSommetsStr_;
 
@@ -125,6 +142,9 @@ private:
     std::string nuanceurTessCtrlStr_;
     std::string nuanceurTessEvalStr_;
 
+    /// la chaîne de caractères du nom de fichier du nuanceur de calcul
+    std::string nuanceurCalculStr_;
+
     /// la liste des uniforms float requis par les nuanceurs
     std::vector<floatUniform> floatUniforms_;
 
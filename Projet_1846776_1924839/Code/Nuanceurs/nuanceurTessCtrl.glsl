@@ -1,60 +1,91 @@
-#version 420
+#version 430
 
 layout(vertices = 4) out;
 
+#include "seaGerstner.glsl"
+
+// Wave model (CVar::waveModel), same value as in SeaNoise.h
+#define SEA_WAVE_GERSTNER 2
+
 uniform	mat4 M;
 uniform	mat4 P;
 uniform	mat4 MV;
 uniform	mat4 MVP;
 uniform vec3 eyePos;
-
-uniform float tscale_negx;
-uniform float tscale_negz;
-uniform float tscale_posx;
-uniform float tscale_posz;
+uniform int waveModel;
+
+// Frustum culling (SeaCull.h): how far the waves move the surface,
+// horizontal reach, lowest and highest vertical displacement.
+uniform int cullOn;
+uniform vec3 displacementBounds;
+// Depth of the skirts drawn by nuanceurTessEval.glsl, 0 without
+uniform float skirtDepth;
+
+// Injected by main.cpp when the TCS can use an atomic counter
+#ifndef SEA_CULL_COUNTER
+#define SEA_CULL_COUNTER 0
+#endif
+#if SEA_CULL_COUNTER
+layout(binding = SEA_CULL_BINDING, offset = 0) uniform atomic_uint culledPatches;
+#endif
+
+// Tessellation levels computed by the CPU for every patch (SeaTess.h),
+// already matched along the seams
+#ifndef SEA_TESS_BINDING
+#define SEA_TESS_BINDING 0
+#endif
+struct SeaTessPatch
+{
+    vec4 outer;
+    vec4 inner; // xy
+};
+layout(std430, binding = SEA_TESS_BINDING) readonly buffer SeaTessLevels
+{
+    SeaTessPatch tessLevels[];
+};
+uniform int patchIndex;
 
 in vec3 vPosition[];
 out vec3 cPosition[];
 
-// The code related to the tesselation level adjustements come from:
-// https://bitbucket.org/victorbush/ufl.cap5705.terrain/src/master/
+// Gerstner waves visible somewhere on the patch, see gerstnerWaveCount()
+patch out float gerstnerPatchWaves;
 
-float dlodCameraDistance(vec4 p0, vec4 p1)
+// Distance from the eye to the closest point of the (flat) patch
+float patchMinDistance()
 {
-
-	vec4 view0 = MV * p0;
-	vec4 view1 = MV * p1;
-
-	float MinDepth = 10.0;
-	float MaxDepth = 100000.0;
-
-	float d0 = clamp( (abs(p0.z) - MinDepth) / (MaxDepth - MinDepth), 0.0, 1.0);
-	float d1 = clamp( (abs(p1.z) - MinDepth) / (MaxDepth - MinDepth), 0.0, 1.0);
-
-	float t = mix(64, 2, (d0 + d1) * 0.5);
-
-	if (t <= 2.0)
-	{ 
-		return 2.0;
-	}
-	if (t <= 4.0)
-	{ 
-		return 4.0;
-	}
-	if (t <= 8.0)
-	{ 
-		return 8.0;
+	vec3 lo = (M * vec4(vPosition[0], 1)).xyz;
+	vec3 hi = lo;
+	for (int i = 1; i < 4; i++)
+	{
+		vec3 p = (M * vec4(vPosition[i], 1)).xyz;
+		lo = min(lo, p);
+		hi = max(hi, p);
 	}
-	if (t <= 16.0)
-	{ 
-		return 16.0;
-	}
-	if (t <= 32.0)
-	{ 
-		return 32.0;
+	return distance(eyePos, clamp(eyePos, lo, hi));
+}
+
+// True when the displaced bounding box of the patch lies entirely outside
+// one of the six clip planes (a conservative test: some boxes crossing a
+// frustum corner are kept).
+bool patchOutsideFrustum()
+{
+	vec3 lo = min(min(vPosition[0], vPosition[1]), min(vPosition[2], vPosition[3]));
+	vec3 hi = max(max(vPosition[0], vPosition[1]), max(vPosition[2], vPosition[3]));
+	lo += vec3(-displacementBounds.x, displacementBounds.y - skirtDepth, -displacementBounds.x);
+	hi += vec3(displacementBounds.x, displacementBounds.z, displacementBounds.x);
+
+	// corners outside each plane: x < -w, x > w, y < -w, y > w, z < -w, z > w
+	ivec3 below = ivec3(0);
+	ivec3 above = ivec3(0);
+	for (int i = 0; i < 8; i++)
+	{
+		vec3 corner = vec3((i & 1) != 0 ? hi.x : lo.x, (i & 2) != 0 ? hi.y : lo.y, (i & 4) != 0 ? hi.z : lo.z);
+		vec4 clip = MVP * vec4(corner, 1);
+		below += ivec3(lessThan(clip.xyz, vec3(-clip.w)));
+		above += ivec3(greaterThan(clip.xyz, vec3(clip.w)));
 	}
-	
-	return 64.0;
+	return any(equal(below, ivec3(8))) || any(equal(above, ivec3(8)));
 }
 
 void main(void)
@@ -67,21 +98,34 @@ void main(void)
     {
         vec3 eyeWorldPos = eyePos;
 
-        gl_TessLevelOuter[0] = dlodCameraDistance(gl_in[3].gl_Position, gl_in[0].gl_Position);
-	    gl_TessLevelOuter[1] = dlodCameraDistance(gl_in[0].gl_Position, gl_in[1].gl_Position);
-	    gl_TessLevelOuter[2] = dlodCameraDistance(gl_in[1].gl_Position, gl_in[2].gl_Position);
-	    gl_TessLevelOuter[3] = dlodCameraDistance(gl_in[2].gl_Position, gl_in[3].gl_Position);
-
-	    if (tscale_posz == 2.0)
-	    	gl_TessLevelOuter[0] = max(2.0, gl_TessLevelOuter[0] * 0.5);
-	    if (tscale_posx == 2.0)
-	    	gl_TessLevelOuter[1] = max(2.0, gl_TessLevelOuter[1] * 0.5);
-	    if (tscale_negz == 2.0)
-	    	gl_TessLevelOuter[2] = max(2.0, gl_TessLevelOuter[2] * 0.5);
-	    if (tscale_negx == 2.0)
-	    	gl_TessLevelOuter[3] = max(2.0, gl_TessLevelOuter[3] * 0.5);
-
-        gl_TessLevelInner[0] = (gl_TessLevelOuter[0] + gl_TessLevelOuter[2]) / 2;
-        gl_TessLevelInner[1] = (gl_TessLevelOuter[1] + gl_TessLevelOuter[3]) / 2;
+        if (cullOn != 0 && patchOutsideFrustum())
+        {
+            // a level of 0 discards the patch before the evaluation shader
+            gl_TessLevelOuter[0] = 0.0;
+            gl_TessLevelOuter[1] = 0.0;
+            gl_TessLevelOuter[2] = 0.0;
+            gl_TessLevelOuter[3] = 0.0;
+            gl_TessLevelInner[0] = 0.0;
+            gl_TessLevelInner[1] = 0.0;
+            gerstnerPatchWaves = 0.0;
+#if SEA_CULL_COUNTER
+            atomicCounterIncrement(culledPatches);
+#endif
+            return;
+        }
+
+        gerstnerPatchWaves = 0.0;
+        if (waveModel == SEA_WAVE_GERSTNER)
+            gerstnerPatchWaves = float(gerstnerWaveCount(patchMinDistance()));
+
+        // quad domain: outer 0 is the u = 0 edge (v0 v3), 1 is v = 0 (v0 v1),
+        // 2 is u = 1 (v1 v2), 3 is v = 1 (v3 v2)
+        SeaTessPatch levels = tessLevels[patchIndex];
+        gl_TessLevelOuter[0] = levels.outer[0];
+        gl_TessLevelOuter[1] = levels.outer[1];
+        gl_TessLevelOuter[2] = levels.outer[2];
+        gl_TessLevelOuter[3] = levels.outer[3];
+        gl_TessLevelInner[0] = levels.inner[0];
+        gl_TessLevelInner[1] = levels.inner[1];
     }
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+// Sea wave noise shared by nuanceurTessEval.glsl and seaCarte.glsl.
+// Included by CNuanceurProg, keep it free of #version and uniforms.
+
+// The code related to the 3d simplex noise come from:
+// https://www.shadertoy.com/view/XsX3zB
+
+// Lattice hash of random3(): 0 = sin() based, 1 = PCG integer hash.
+// Injected by main.cpp from SEA_NOISE_INT_HASH (SeaNoise.h).
+#ifndef SEA_NOISE_INT_HASH
+#define SEA_NOISE_INT_HASH 0
+#endif
+
+///* skew constants for 3d simplex functions */
+const float F3 =  0.3333333;
+const float G3 =  0.1666667;
+
+///* const matrices for 3d rotation */
+const mat3 rot1 = mat3(-0.37, 0.36, 0.85,-0.14,-0.93, 0.34,0.92, 0.01,0.4);
+const mat3 rot2 = mat3(-0.55,-0.39, 0.74, 0.33,-0.91,-0.24,0.77, 0.12,0.63);
+const mat3 rot3 = mat3(-0.71, 0.52,-0.47,-0.08,-0.72,-0.68,-0.7,-0.45,0.56);
+
+#if SEA_NOISE_INT_HASH
+// PCG3D hash (Jarzynski & Olano 2020). Integer only, so it is exact at any
+// coordinate and bit-identical to the CPU port.
+uvec3 pcg3d(uvec3 v) {
+	v = v * 1664525u + 1013904223u;
+	v.x += v.y*v.z;
+	v.y += v.z*v.x;
+	v.z += v.x*v.y;
+	v ^= v >> 16u;
+	v.x += v.y*v.z;
+	v.y += v.z*v.x;
+	v.z += v.x*v.y;
+	return v;
+}
+
+// c only holds integers (lattice points), 24 bits kept per component
+vec3 random3(vec3 c) {
+	uvec3 h = pcg3d(uvec3(ivec3(c)));
+	return vec3(h >> 8u) * (1.0 / 16777216.0) - 0.5;
+}
+#else
+// sin() with a fixed range reduction and polynomial. random3() amplifies the
+// sine by 4096*512, so the driver's sin() would make the CPU port of these
+// waves (SeaKernels.h) diverge. Keep both in sync.
+float seaSin(float x) {
+	precise float k = floor(x * 0.318309886 + 0.5);
+	precise float r = x - k * 3.140625;
+	r = r - k * 9.67502593994140625e-4;
+	r = r - k * 1.509957990978376432e-7;
+	precise float parity = k - 2.0 * floor(k * 0.5);
+
+	precise float r2 = r * r;
+	precise float p = -2.5052108e-8;
+	p = p * r2 + 2.7557319e-6;
+	p = p * r2 - 1.9841270e-4;
+	p = p * r2 + 8.3333333e-3;
+	p = p * r2 - 1.6666667e-1;
+	precise float s = r + r * r2 * p;
+	return s * (1.0 - 2.0 * parity);
+}
+
+vec3 random3(vec3 c) {
+	precise float j = 4096.0*seaSin(c.x*17.0 + c.y*59.4 + c.z*15.0);
+	precise vec3 r;
+	r.z = fract(512.0*j);
+	j *= .125;
+	r.x = fract(512.0*j);
+	j *= .125;
+	r.y = fract(512.0*j);
+	return r-0.5;
+}
+#endif
+
+///* 3d simplex noise */
+float simplex3d(vec3 p) {
+	 /* 1. find current tetrahedron T and it's four vertices */
+	 /* s, s+i1, s+i2, s+1.0 - absolute skewed (integer) coordinates of T vertices */
+	 /* x, x1, x2, x3 - unskewed coordinates of p relative to each of T vertices*/
+	 
+	 /* calculate s and x */
+	 vec3 s = floor(p + dot(p, vec3(F3)));
+	 vec3 x = p - s + dot(s, vec3(G3));
+	 
+	 /* calculate i1 and i2 */
+	 vec3 e = step(vec3(0.0), x - x.yzx);
+	 vec3 i1 = e*(1.0 - e.zxy);
+	 vec3 i2 = 1.0 - e.zxy*(1.0 - e);
+	 	
+	 /* x1, x2, x3 */
+	 vec3 x1 = x - i1 + G3;
+	 vec3 x2 = x - i2 + 2.0*G3;
+	 vec3 x3 = x - 1.0 + 3.0*G3;
+	 
+	 /* 2. find four surflets and store them in d */
+	 vec4 w, d;
+	 
+	 /* calculate surflet weights */
+	 w.x = dot(x, x);
+	 w.y = dot(x1, x1);
+	 w.z = dot(x2, x2);
+	 w.w = dot(x3, x3);
+	 
+	 /* w fades from 0.6 at the center of the surflet to 0.0 at the margin */
+	 w = max(0.6 - w, 0.0);
+	 
+	 /* calculate surflet components */
+	 d.x = dot(random3(s), x);
+	 d.y = dot(random3(s + i1), x1);
+	 d.z = dot(random3(s + i2), x2);
+	 d.w = dot(random3(s + 1.0), x3);
+	 
+	 /* multiply d by w^4 */
+	 w *= w;
+	 w *= w;
+	 d *= w;
+	 
+	 /* 3. return the sum of the four surflets */
+	 return dot(d, vec4(52.0));
+}
+
+///* directional artifacts can be reduced by rotating each octave */
+float simplex3d_fractal(vec3 m) {
+    return   0.5333333*simplex3d(m*rot1)
+			+0.2666667*simplex3d(2.0*m*rot2)
+			+0.1333333*simplex3d(4.0*m*rot3)
+			+0.0666667*simplex3d(8.0*m);
+}
+
+
+// Wave height above the sea plane at world position (x, z).
+float seaWaveHeight(vec2 worldXZ, float time, float waveSize)
+{
+    vec3 params = vec3(worldXZ / 500.f, time * 0.003);
+    float height = simplex3d_fractal(params * 20 + 20);
+    return (0.5 + 0.5 * height) * waveSize;
+}
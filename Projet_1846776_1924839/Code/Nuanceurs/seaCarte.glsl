@@ -0,0 +1,39 @@
+#version 430
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+// Bakes one tile of one snapshot of the sea displacement map (see SeaMap.cpp).
+// One invocation per texel.
+
+#include "seaBruit.glsl"
+
+// .x = wave height, .yzw = world normal
+layout(binding = 0, rgba32f) uniform writeonly image2DArray seaMap;
+
+uniform float Time;
+uniform float waveSize;
+
+// first texel of the tile, layer of the snapshot and its world placement
+uniform ivec2 seaMapTile;
+uniform int seaMapLayer;
+uniform vec2 seaMapOrigin;
+uniform float seaMapExtent;
+
+void main()
+{
+    ivec2 texel = seaMapTile + ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(seaMap).xy;
+    if (texel.x >= size.x || texel.y >= size.y)
+        return;
+
+    // texel centre, as sampled by textureLod() in nuanceurTessEval.glsl
+    vec2 p = seaMapOrigin + (vec2(texel) + 0.5) / vec2(size) * seaMapExtent;
+
+    float h  = seaWaveHeight(p, Time, waveSize);
+    float hx = seaWaveHeight(p + vec2(0.1, 0.0), Time, waveSize);
+    float hz = seaWaveHeight(p + vec2(0.0, 0.1), Time, waveSize);
+
+    // cross((0, hz - h, 0.1), (0.1, hx - h, 0)), same as getNormal() in the TES
+    vec3 n = normalize(vec3(-0.1 * (hx - h), 0.01, -0.1 * (hz - h)));
+
+    imageStore(seaMap, ivec3(texel, seaMapLayer), vec4(h, n));
+}
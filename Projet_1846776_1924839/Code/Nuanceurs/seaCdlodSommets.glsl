@@ -0,0 +1,52 @@
+#version 430 core
+
+// Sea without tessellation stages (SeaCdlod.h): every quadtree leaf draws
+// the same grid, and the vertices morph towards the grid of the parent level
+// as the distance nears the one where the parent stops being split. The
+// morphs are computed by the CPU, from the distances the quadtree uses.
+
+#include "seaSurface.glsl"
+
+// Injected by main.cpp from SeaCdlod.h
+#ifndef SEA_CDLOD_GRID
+#define SEA_CDLOD_GRID 32
+#endif
+
+// Grid vertex in [0, 1]^2, SEA_CDLOD_GRID quads a side
+layout(location = 0) in vec2 gridPos;
+// Per leaf: centre x, centre z, size, rest height (model space)
+layout(location = 1) in vec4 nodeBounds;
+// Per leaf: morph of the vertices on each side (+z, +x, -z, -x), matched
+// with the neighbours, and of the other vertices
+layout(location = 2) in vec4 nodeSides;
+layout(location = 3) in float nodeMorph;
+
+void main()
+{
+	float size = nodeBounds.z;
+
+	// continuous LOD: from the full grid to every other vertex of it. The
+	// edges take the morph both sides of the seam agreed on; corners are
+	// even vertices, which don't move.
+	float morph = nodeMorph;
+	ivec2 index = ivec2(round(gridPos * float(SEA_CDLOD_GRID)));
+	bvec4 onSide = bvec4(index.y == SEA_CDLOD_GRID, index.x == SEA_CDLOD_GRID, index.y == 0, index.x == 0);
+	for (int i = 0; i < 4; i++)
+	{
+		if (onSide[i])
+			morph = nodeSides[i];
+	}
+
+	// odd vertices slide onto their even neighbour
+	vec2 odd = fract(gridPos * float(SEA_CDLOD_GRID) * 0.5) * 2.0 / float(SEA_CDLOD_GRID);
+	vec2 morphed = nodeBounds.xy + (gridPos - odd * morph - 0.5) * size;
+	vec4 pos = vec4(morphed.x, nodeBounds.w, morphed.y, 1);
+
+	int gerstnerWaves = 0;
+	if (waveModel == SEA_WAVE_GERSTNER)
+		gerstnerWaves = gerstnerWaveCount(distance((M * pos).xyz, eyePos));
+
+	vec3 worldNormal;
+	vec4 posInterpol = seaSurface(pos, gerstnerWaves, worldNormal);
+	seaShade(posInterpol, worldNormal);
+}
@@ -0,0 +1,45 @@
+#version 430 core
+
+// Geometry clipmap sea (SeaClipmap.h): one block of a level per instance.
+// The vertices near the outer border of a level slide onto the grid of the
+// next, twice coarser, level, which starts exactly at that border.
+
+#include "seaSurface.glsl"
+
+// Injected by main.cpp from SeaClipmap.h
+#ifndef SEA_CLIPMAP_BLOCK
+#define SEA_CLIPMAP_BLOCK 32
+#endif
+#define SEA_CLIPMAP_SIZE (4 * SEA_CLIPMAP_BLOCK)
+
+// Vertex of the block, in cells
+layout(location = 0) in vec2 gridPos;
+// Per instance: position of the block in its level, in cells
+layout(location = 1) in vec2 blockOffset;
+
+uniform vec2 clipmapCorner; // lower corner of the level, model space x z
+uniform float clipmapCell;  // metres per cell of the level
+uniform int clipmapMorph;   // cells from the outer border over which the level morphs
+
+void main()
+{
+	vec2 cell = blockOffset + gridPos;
+
+	// 1 on the outer border, 0 from clipmapMorph cells inside
+	float border = min(min(cell.x, cell.y), min(float(SEA_CLIPMAP_SIZE) - cell.x, float(SEA_CLIPMAP_SIZE) - cell.y));
+	float morph = clamp(1.0 - border / float(clipmapMorph), 0.0, 1.0);
+
+	// odd vertices slide onto their even neighbour, a vertex of the coarser level
+	cell -= mod(cell, 2.0) * morph;
+
+	vec2 rest = clipmapCorner + cell * clipmapCell;
+	vec4 pos = vec4(rest.x, 0, rest.y, 1);
+
+	int gerstnerWaves = 0;
+	if (waveModel == SEA_WAVE_GERSTNER)
+		gerstnerWaves = gerstnerWaveCount(distance((M * pos).xyz, eyePos));
+
+	vec3 worldNormal;
+	vec4 posInterpol = seaSurface(pos, gerstnerWaves, worldNormal);
+	seaShade(posInterpol, worldNormal);
+}
@@ -0,0 +1,69 @@
+// Gerstner waves shared by nuanceurTessCtrl.glsl and nuanceurTessEval.glsl.
+// Unlike seaBruit.glsl it declares its uniforms: both stages belong to the
+// same program and read the same wave set (SeaGerstner.cpp).
+
+// Injected by main.cpp from SeaGerstner.h
+#ifndef SEA_GERSTNER_MAX_WAVES
+#define SEA_GERSTNER_MAX_WAVES 32
+#endif
+#ifndef SEA_GERSTNER_BINDING
+#define SEA_GERSTNER_BINDING 1
+#endif
+
+// Sorted by decreasing wavelength, phases already advanced to the current time
+layout(std140, binding = SEA_GERSTNER_BINDING) uniform SeaGerstner
+{
+    vec4 gerstnerDirK[SEA_GERSTNER_MAX_WAVES];     // direction.xz, k, wavelength
+    vec4 gerstnerAmpPhase[SEA_GERSTNER_MAX_WAVES]; // amplitude, choppiness * amplitude, phase
+    int gerstnerCount;
+};
+
+uniform int gerstnerBudget;     // CVar::gerstnerWaveBudget
+uniform float gerstnerPixelBase;  // size of a pixel at distance d:
+uniform float gerstnerPixelScale; // base + scale * d
+
+// 1 for waves longer than four pixels at distance d, fading to 0 at two pixels
+// (their Nyquist limit). Only depends on d, so shared vertices of
+// neighbouring patches always agree.
+float gerstnerVisibility(float wavelength, float d)
+{
+    float pixel = gerstnerPixelBase + gerstnerPixelScale * d;
+    return clamp(wavelength / (2.0 * pixel) - 1.0, 0.0, 1.0);
+}
+
+// Waves worth evaluating for a patch whose closest point is dMin away:
+// every later wave has a visibility of 0 on the whole patch.
+int gerstnerWaveCount(float dMin)
+{
+    int count = min(gerstnerCount, gerstnerBudget);
+    for (int i = 0; i < count; i++)
+    {
+        if (gerstnerVisibility(gerstnerDirK[i].w, dMin) <= 0.0)
+            return i;
+    }
+    return count;
+}
+
+// Displacement of the surface point at rest position worldXZ, d away from the
+// eye, from the first "count" waves, and its analytic normal.
+void gerstnerSurface(vec2 worldXZ, float d, int count, out vec3 displacement, out vec3 normal)
+{
+    displacement = vec3(0.0);
+    normal = vec3(0.0, 1.0, 0.0);
+    for (int i = 0; i < count; i++)
+    {
+        vec2 dir = gerstnerDirK[i].xy;
+        float k = gerstnerDirK[i].z;
+        float fade = gerstnerVisibility(gerstnerDirK[i].w, d);
+        float amplitude = gerstnerAmpPhase[i].x * fade;
+        float chop = gerstnerAmpPhase[i].y * fade;
+
+        float theta = k * dot(dir, worldXZ) + gerstnerAmpPhase[i].z;
+        float s = sin(theta);
+        float c = cos(theta);
+
+        displacement += vec3(chop * dir.x * c, amplitude * s, chop * dir.y * c);
+        normal -= vec3(dir.x * k * amplitude * c, k * chop * s, dir.y * k * amplitude * c);
+    }
+    normal = normalize(normal);
+}
@@ -0,0 +1,199 @@
+// Sea surface shared by nuanceurTessEval.glsl and seaCdlodSommets.glsl: the
+// displacement of every wave model and the lighting outputs read by
+// seaFragments.glsl. The including stage declares #version.
+
+#include "seaBruit.glsl"
+#include "seaGerstner.glsl"
+
+// Levels of the displacement map written by seaCarte.glsl (SEA_MAP_LEVELS in SeaMap.h)
+#ifndef SEA_MAP_LEVELS
+#define SEA_MAP_LEVELS 6
+#endif
+
+// Wave models (CVar::waveModel)
+#define SEA_WAVE_NOISE 0
+#define SEA_WAVE_FFT 1
+#define SEA_WAVE_GERSTNER 2
+
+struct Light
+{
+        vec3 Ambient; 
+        vec3 Diffuse;
+        vec3 Specular;
+        vec4 Position;  // Si .w = 1.0 -> Direction de lumiere directionelle.
+        vec3 SpotDir;
+        float SpotExp;
+        float SpotCutoff;
+        vec3 Attenuation; //Constante, Lineraire, Quadratique
+};
+
+struct Mat
+{
+        vec4 Ambient; 
+        vec4 Diffuse;
+        vec4 Specular;
+        vec4 Exponent;
+        float Shininess;
+};
+
+// Uniforms
+uniform float Time;
+uniform	mat4 M;
+uniform	mat4 V;
+uniform	mat4 P;
+uniform	mat4 MV;
+uniform	mat4 MVP;
+uniform	mat3 N;
+uniform	unsigned int waveSize;
+uniform vec3 eyePos;
+
+uniform Light Lights[3];
+uniform Mat Material;
+uniform int pointLightOn;
+uniform int spotLightOn;
+uniform int dirLightOn;
+
+// Displacement map: .x = wave height, .yzw = world normal. Level i covers
+// seaMapExtent[i] metres and blends two snapshots baked at different times
+// (layers seaMapPrevLayer[i] and seaMapNextLayer[i], see SeaMap.cpp).
+uniform int seaMapOn;
+uniform sampler2DArray seaMap;
+uniform float seaMapExtent[SEA_MAP_LEVELS];
+uniform vec2 seaMapPrevOrigin[SEA_MAP_LEVELS];
+uniform vec2 seaMapNextOrigin[SEA_MAP_LEVELS];
+uniform int seaMapPrevLayer[SEA_MAP_LEVELS];
+uniform int seaMapNextLayer[SEA_MAP_LEVELS];
+uniform float seaMapBlend[SEA_MAP_LEVELS];
+
+// Spectral ocean patch computed on the CPU (SeaFft.cpp), tiled every
+// seaFftPatchSize metres: displacement .xyz = (dx, h, dz), slope .xy = (dh/dx, dh/dz)
+uniform int waveModel;
+uniform sampler2D seaFftDisplacement;
+uniform sampler2D seaFftSlope;
+uniform float seaFftPatchSize;
+uniform float seaFftChoppiness;
+
+// Outputs, read by seaFragments.glsl
+out vec3 colorOut;
+out vec3 normal;
+
+out vec3 fragLight0Vect;
+out vec3 fragLight1Vect;
+out vec3 fragLight2Vect;
+
+vec4 height( vec4 pos )
+{
+	float heightVal = seaWaveHeight((M * pos).xz, Time, waveSize);
+	return M * (pos + vec4(0 , heightVal , 0 , 0));
+}
+
+// Level i of the map at worldXZ, interpolated between its two snapshots.
+// d is how far worldXZ is from the centre of the level (0.5 = its border).
+vec4 seaMapLevel(int i, vec2 worldXZ, out float d)
+{
+	vec2 uv = (worldXZ - seaMapNextOrigin[i]) / seaMapExtent[i];
+	vec4 m = textureLod(seaMap, vec3(uv, seaMapNextLayer[i]), 0.0);
+	d = max(abs(uv.x - 0.5), abs(uv.y - 0.5));
+	if (seaMapBlend[i] < 1.0)
+	{
+		vec2 uvPrev = (worldXZ - seaMapPrevOrigin[i]) / seaMapExtent[i];
+		m = mix(textureLod(seaMap, vec3(uvPrev, seaMapPrevLayer[i]), 0.0), m, seaMapBlend[i]);
+		d = max(d, max(abs(uvPrev.x - 0.5), abs(uvPrev.y - 0.5)));
+	}
+	return m;
+}
+
+// Samples the finest level of the map containing worldXZ and fades into the
+// next one near its border. Only depends on worldXZ, so neighbouring patches
+// get the same value on their shared edges.
+vec4 seaMapSample(vec2 worldXZ)
+{
+	for (int i = 0; i < SEA_MAP_LEVELS; i++)
+	{
+		float d;
+		vec4 m = seaMapLevel(i, worldXZ, d);
+		if (d < 0.45 || i == SEA_MAP_LEVELS - 1)
+		{
+			float fade = smoothstep(0.35, 0.45, d);
+			if (fade > 0.0 && i < SEA_MAP_LEVELS - 1)
+			{
+				float dNext;
+				m = mix(m, seaMapLevel(i + 1, worldXZ, dNext), fade);
+			}
+			return m;
+		}
+	}
+	return vec4(0.0, 0.0, 1.0, 0.0);
+}
+
+vec3 getNormal(vec3 ws_p1, vec3 ws_p2, vec3 ws_p3)
+{
+    vec4 edge1 = normalize((vec4(ws_p1, 2) - vec4(ws_p2, 1)));
+    vec4 edge2 = normalize((vec4(ws_p3, 3) - vec4(ws_p2, 2)));
+    vec3 e1 = vec3(edge1.x, edge1.y, edge1.z);
+    vec3 e2 =  vec3(edge2.x, edge2.y, edge2.z);
+
+    return normalize(cross(e1, e2));
+}
+
+out vec3 Light0HV;
+out vec3 Light1HV;
+out vec3 Light2HV;
+
+// World position of the model space rest position pos, displaced by the
+// active wave model, and the world normal there. gerstnerWaves is the number
+// of Gerstner waves worth evaluating (see gerstnerWaveCount()).
+vec4 seaSurface(vec4 pos, int gerstnerWaves, out vec3 worldNormal)
+{
+	vec4 posInterpol;
+	if (waveModel == SEA_WAVE_FFT)
+	{
+		// sample (i, j) sits at (i, j) * patchSize / N, on the texel centre
+		vec2 uv = (M * pos).xz / seaFftPatchSize + 0.5 / float(textureSize(seaFftDisplacement, 0).x);
+		vec3 d = textureLod(seaFftDisplacement, uv, 0.0).xyz;
+		vec2 slope = textureLod(seaFftSlope, uv, 0.0).xy;
+		posInterpol = M * pos + vec4(d.x * seaFftChoppiness, d.y, d.z * seaFftChoppiness, 0);
+		worldNormal = normalize(vec3(-slope.x, 1.0, -slope.y));
+	}
+	else if (waveModel == SEA_WAVE_GERSTNER)
+	{
+		// distance of the rest position, the same for every patch sharing the vertex
+		vec4 world = M * pos;
+		vec3 displacement;
+		gerstnerSurface(world.xz, distance(world.xyz, eyePos), gerstnerWaves, displacement, worldNormal);
+		posInterpol = world + vec4(displacement, 0);
+	}
+	else if (seaMapOn != 0)
+	{
+		vec4 m = seaMapSample((M * pos).xz);
+		posInterpol = M * (pos + vec4(0, m.x, 0, 0));
+		worldNormal = normalize(m.yzw);
+	}
+	else
+	{
+		posInterpol = height(pos);
+		vec4 posInterpolXP = height(pos + vec4(0.1, 0, 0, 0));
+		vec4 posInterpolZP = height(pos + vec4(0, 0, 0.1, 0));
+		worldNormal = getNormal(posInterpolZP.xyz, posInterpol.xyz, posInterpolXP.xyz);
+	}
+	return posInterpol;
+}
+
+// Writes gl_Position and the outputs for seaFragments.glsl.
+void seaShade(vec4 posInterpol, vec3 worldNormal)
+{
+    gl_Position = P * V * posInterpol;
+
+	normal = mat3(V) * worldNormal;
+
+	vec4 ecPosition = V * posInterpol;
+	vec3 ecPosition3;
+	ecPosition3 = (vec3 (ecPosition)) / ecPosition.w;
+	fragLight0Vect = vec3 (Lights[0].Position) - ecPosition3;
+    fragLight1Vect = vec3 (Lights[1].Position) - ecPosition3;
+    fragLight2Vect = vec3 (-Lights[2].Position);
+
+	Light0HV = normalize(fragLight0Vect - ecPosition.xyz);
+	Light1HV = normalize(fragLight1Vect - ecPosition.xyz);
+	Light2HV = normalize(-fragLight2Vect);
+}
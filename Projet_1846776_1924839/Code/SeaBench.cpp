@@ -0,0 +1,259 @@
+// Offscreen benchmark, see SeaBench.h.
+
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "SeaBench.h"
+#include "SeaMemory.h"
+#include "Var.h"
+
+struct SeaBenchKey
+{
+    double         time;
+    SeaBenchCamera camera;
+};
+
+struct SeaBenchFrame
+{
+    double    cpuMs;
+    double    gpuMs; // -1 until its queries are read
+    int       patches;
+    long long churn; // bytes created and deleted, SeaMemory.h
+};
+
+static std::vector<SeaBenchKey>   benchKeys;
+static std::vector<SeaBenchFrame> benchFrames;
+static GLuint                     benchFbo                           = 0;
+static GLuint                     benchColor                         = 0;
+static GLuint                     benchDepth                         = 0;
+static GLuint                     benchQueries[SEA_BENCH_QUERIES][2] = { { 0 } };
+static int                        benchWidth                         = 0;
+static int                        benchHeight                        = 0;
+
+bool seaBenchLoadPath(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "Impossible d'ouvrir le chemin %s\n", path);
+        return false;
+    }
+
+    benchKeys.clear();
+    char line[256];
+    int  number = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        number++;
+        char first = ' ';
+        if (sscanf(line, " %c", &first) != 1 || first == '#')
+            continue;
+
+        SeaBenchKey key;
+        float       h, v;
+        if (sscanf(line, "%lf %f %f %f %f %f", &key.time, &key.camera.position.x, &key.camera.position.y,
+                   &key.camera.position.z, &h, &v) != 6
+            || (!benchKeys.empty() && key.time <= benchKeys.back().time))
+        {
+            fprintf(stderr, "%s:%d: clé invalide\n", path, number);
+            fclose(file);
+            return false;
+        }
+        key.camera.horizontalAngle = glm::radians(h);
+        key.camera.verticalAngle   = glm::radians(v);
+        benchKeys.push_back(key);
+    }
+    fclose(file);
+
+    if (benchKeys.empty())
+        fprintf(stderr, "%s: aucune clé\n", path);
+    return !benchKeys.empty();
+}
+
+double seaBenchDuration()
+{
+    return benchKeys.empty() ? 0.0 : benchKeys.back().time;
+}
+
+SeaBenchCamera seaBenchCamera(double t)
+{
+    if (t <= benchKeys.front().time)
+        return benchKeys.front().camera;
+    if (t >= benchKeys.back().time)
+        return benchKeys.back().camera;
+
+    size_t i = 1;
+    while (benchKeys[i].time < t)
+        i++;
+    const SeaBenchKey& a = benchKeys[i - 1];
+    const SeaBenchKey& b = benchKeys[i];
+    float              s = float((t - a.time) / (b.time - a.time));
+
+    SeaBenchCamera camera;
+    camera.position        = glm::mix(a.camera.position, b.camera.position, s);
+    camera.horizontalAngle = glm::mix(a.camera.horizontalAngle, b.camera.horizontalAngle, s);
+    camera.verticalAngle   = glm::mix(a.camera.verticalAngle, b.camera.verticalAngle, s);
+    return camera;
+}
+
+GLuint seaBenchInit(int width, int height)
+{
+    benchWidth  = width;
+    benchHeight = height;
+    benchFrames.clear();
+
+    seaMemGenTextures(SeaMemTextures, 1, &benchColor);
+    glBindTexture(GL_TEXTURE_2D, benchColor);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    seaMemTextureSize(benchColor, 4LL * width * height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    seaMemGenRenderbuffers(SeaMemTargets, 1, &benchDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, benchDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    seaMemRenderbufferSize(benchDepth, 4LL * width * height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &benchFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, benchFbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, benchColor, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, benchDepth);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        fprintf(stderr, "Framebuffer du banc d'essai incomplet (0x%x)\n", status);
+        seaBenchShutdown();
+        return 0;
+    }
+
+    for (int i = 0; i < SEA_BENCH_QUERIES; i++)
+        glGenQueries(2, benchQueries[i]);
+    return benchFbo;
+}
+
+void seaBenchShutdown()
+{
+    if (benchQueries[0][0])
+    {
+        for (int i = 0; i < SEA_BENCH_QUERIES; i++)
+            glDeleteQueries(2, benchQueries[i]);
+    }
+    glDeleteFramebuffers(1, &benchFbo);
+    seaMemDeleteRenderbuffers(1, &benchDepth);
+    seaMemDeleteTextures(1, &benchColor);
+    benchFbo = benchDepth = benchColor = 0;
+    benchQueries[0][0]                 = 0;
+}
+
+/// Reads the GPU time of a finished frame, waiting for it if needed.
+static void readFrame(size_t frame)
+{
+    GLuint*  queries = benchQueries[frame % SEA_BENCH_QUERIES];
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &end);
+    benchFrames[frame].gpuMs = static_cast<double>(end - begin) * 1e-6;
+}
+
+void seaBenchBeginFrame()
+{
+    // the pair about to be reused belongs to SEA_BENCH_QUERIES frames ago
+    size_t frame = benchFrames.size();
+    if (frame >= SEA_BENCH_QUERIES)
+        readFrame(frame - SEA_BENCH_QUERIES);
+    glQueryCounter(benchQueries[frame % SEA_BENCH_QUERIES][0], GL_TIMESTAMP);
+}
+
+void seaBenchEndFrame(double cpuMs, int patches)
+{
+    SeaBenchFrame f = { cpuMs, -1.0, patches, seaMemFrameChurn() };
+    glQueryCounter(benchQueries[benchFrames.size() % SEA_BENCH_QUERIES][1], GL_TIMESTAMP);
+    benchFrames.push_back(f);
+}
+
+/// Writes "name": {mean, p50, p90, p95, p99, max} of a measure.
+static void writeSummary(FILE* out, const char* name, std::vector<double> values, bool last)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < values.size(); i++)
+        sum += values[i];
+    std::sort(values.begin(), values.end());
+
+    // nearest rank
+    const double ranks[4]  = { 0.5, 0.9, 0.95, 0.99 };
+    const char*  labels[4] = { "p50", "p90", "p95", "p99" };
+    fprintf(out, "  \"%s\": { \"mean\": %.4f", name, values.empty() ? 0.0 : sum / values.size());
+    for (int r = 0; r < 4; r++)
+    {
+        size_t i = static_cast<size_t>(std::ceil(ranks[r] * values.size()));
+        fprintf(out, ", \"%s\": %.4f", labels[r], values.empty() ? 0.0 : values[std::max<size_t>(i, 1) - 1]);
+    }
+    fprintf(out, ", \"max\": %.4f }%s\n", values.empty() ? 0.0 : values.back(), last ? "" : ",");
+}
+
+/// Writes a JSON string, escaped.
+static void writeString(FILE* out, const char* s)
+{
+    fputc('"', out);
+    for (; s && *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', out);
+        if (static_cast<unsigned char>(*s) >= 0x20)
+            fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+bool seaBenchWriteJson(const char* path, const char* renderer)
+{
+    glFinish();
+    size_t frames = benchFrames.size();
+    for (size_t f = frames > SEA_BENCH_QUERIES ? frames - SEA_BENCH_QUERIES : 0; f < frames; f++)
+        readFrame(f);
+
+    FILE* out = fopen(path, "w");
+    if (!out)
+    {
+        fprintf(stderr, "Impossible d'écrire %s\n", path);
+        return false;
+    }
+
+    std::vector<double> cpu, gpu, patches, churn;
+    for (size_t f = 0; f < frames; f++)
+    {
+        cpu.push_back(benchFrames[f].cpuMs);
+        gpu.push_back(benchFrames[f].gpuMs);
+        patches.push_back(benchFrames[f].patches);
+        churn.push_back(static_cast<double>(benchFrames[f].churn));
+    }
+
+    fprintf(out, "{\n  \"gl_renderer\": ");
+    writeString(out, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    fprintf(out, ",\n  \"renderer\": ");
+    writeString(out, renderer);
+    fprintf(out, ",\n  \"wave_model\": %d,\n  \"width\": %d,\n  \"height\": %d,\n  \"dt\": %.6f,\n  \"frames\": %u,\n",
+            CVar::waveModel, benchWidth, benchHeight, SEA_BENCH_DT, static_cast<unsigned>(frames));
+    writeSummary(out, "cpu_ms", cpu, false);
+    writeSummary(out, "gpu_ms", gpu, false);
+    writeSummary(out, "patches", patches, false);
+    writeSummary(out, "churn_bytes", churn, false);
+    seaMemWriteJson(out);
+    fprintf(out, ",\n");
+
+    fprintf(out, "  \"per_frame\": [\n");
+    for (size_t f = 0; f < frames; f++)
+    {
+        fprintf(out,
+                "    { \"frame\": %u, \"time\": %.4f, \"cpu_ms\": %.4f, \"gpu_ms\": %.4f, \"patches\": %d, "
+                "\"churn_bytes\": %lld }%s\n",
+                static_cast<unsigned>(f), f * SEA_BENCH_DT, benchFrames[f].cpuMs, benchFrames[f].gpuMs,
+                benchFrames[f].patches, benchFrames[f].churn, f + 1 < frames ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+    return true;
+}
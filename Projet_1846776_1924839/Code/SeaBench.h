@@ -0,0 +1,62 @@
+#pragma once
+// Offscreen benchmark (--benchmark): the camera follows a scripted path,
+// CVar::temps advances by a fixed step, the scene is drawn into an
+// offscreen framebuffer and every frame's CPU time, GPU time, patch count
+// and memory churn (SeaMemory.h) are written to a JSON report with their
+// percentiles, followed by the memory held at the end.
+//
+// Without a display it needs GLFW 3.4, whose null platform hosts the EGL or
+// OSMesa (--osmesa) context. Built with an older GLFW, the window is only
+// hidden and --benchmark needs a display like the interactive mode.
+//
+// Path files hold one key per line, linearly interpolated:
+//     time x y z horizontalAngle verticalAngle
+// in seconds, metres and degrees (the angles of mouseMovement()). Empty
+// lines and lines starting with # are skipped.
+//
+// GPU times come from GL_TIMESTAMP queries, read SEA_BENCH_QUERIES - 1
+// frames late; they don't interfere with the GL_TIME_ELAPSED query of SeaLod.h.
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// framebuffer size, whatever the window
+#define SEA_BENCH_WIDTH 1280
+#define SEA_BENCH_HEIGHT 720
+// simulation step (s)
+#define SEA_BENCH_DT (1.0 / 60.0)
+// frames drawn at the start of the path before measuring
+#define SEA_BENCH_WARMUP 30
+// timestamp pairs in flight
+#define SEA_BENCH_QUERIES 4
+
+struct SeaBenchCamera
+{
+    glm::vec3 position;
+    float     horizontalAngle; // radians
+    float     verticalAngle;   // radians
+};
+
+/// Reads a path file. False, with a message on stderr, when it can't be used.
+bool seaBenchLoadPath(const char* path);
+
+/// Time of the last key (s).
+double seaBenchDuration();
+
+/// Camera at time t, clamped to the path.
+SeaBenchCamera seaBenchCamera(double t);
+
+/// Creates the framebuffer and the queries. Needs a GL context. Returns the
+/// framebuffer to draw into, 0 on failure.
+GLuint seaBenchInit(int width, int height);
+void seaBenchShutdown();
+
+/// Around the frame's GL work. cpuMs is its CPU time, patches what was drawn.
+void seaBenchBeginFrame();
+void seaBenchEndFrame(double cpuMs, int patches);
+
+/**
+* Waits for the last queries and writes the report: settings, then the mean,
+* percentiles and maximum of each measure, then every frame.
+*/
+bool seaBenchWriteJson(const char* path, const char* renderer);
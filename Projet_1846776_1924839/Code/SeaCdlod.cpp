@@ -0,0 +1,119 @@
+// Sea without tessellation stages, see SeaCdlod.h.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "SeaCdlod.h"
+#include "SeaMemory.h"
+#include "SeaTess.h"
+
+static GLuint  cdlodVao        = 0;
+static GLuint  cdlodGrid       = 0;
+static GLuint  cdlodIndices    = 0;
+static GLuint  cdlodInstances  = 0;
+static GLsizei cdlodIndexCount = 0;
+
+void seaCdlodInit()
+{
+    const int n = SEA_CDLOD_GRID;
+
+    std::vector<glm::vec2> vertices;
+    vertices.reserve((n + 1) * (n + 1));
+    for (int j = 0; j <= n; j++)
+    {
+        for (int i = 0; i <= n; i++)
+            vertices.push_back(glm::vec2(static_cast<float>(i) / n, static_cast<float>(j) / n));
+    }
+
+    // two triangles a quad, the diagonal from (i, j) to (i + 1, j + 1): odd
+    // vertices slide towards lower indices, so the fully morphed grid is
+    // made of the same triangles as the parent's grid
+    std::vector<GLuint> indices;
+    indices.reserve(n * n * 6);
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            GLuint a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+            GLuint quad[6] = { a, b, d, a, d, c };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+    cdlodIndexCount = static_cast<GLsizei>(indices.size());
+
+    seaMemGenVertexArrays(SeaMemBuffers, 1, &cdlodVao);
+    glBindVertexArray(cdlodVao);
+
+    seaMemGenBuffers(SeaMemBuffers, 1, &cdlodGrid);
+    glBindBuffer(GL_ARRAY_BUFFER, cdlodGrid);
+    seaMemBufferData(cdlodGrid, GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(0);
+
+    seaMemGenBuffers(SeaMemBuffers, 1, &cdlodInstances);
+    glBindBuffer(GL_ARRAY_BUFFER, cdlodInstances);
+    seaMemBufferData(cdlodInstances, GL_ARRAY_BUFFER, SEA_TESS_MAX_PATCHES * sizeof(SeaCdlodInstance), NULL,
+                     GL_STREAM_DRAW);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SeaCdlodInstance),
+                          reinterpret_cast<void*>(offsetof(SeaCdlodInstance, bounds)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SeaCdlodInstance),
+                          reinterpret_cast<void*>(offsetof(SeaCdlodInstance, sides)));
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(SeaCdlodInstance),
+                          reinterpret_cast<void*>(offsetof(SeaCdlodInstance, morph)));
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribDivisor(2, 1);
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glEnableVertexAttribArray(3);
+
+    seaMemGenBuffers(SeaMemBuffers, 1, &cdlodIndices);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cdlodIndices);
+    seaMemBufferData(cdlodIndices, GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(),
+                     GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void seaCdlodShutdown()
+{
+    seaMemDeleteVertexArrays(1, &cdlodVao);
+    seaMemDeleteBuffers(1, &cdlodGrid);
+    seaMemDeleteBuffers(1, &cdlodIndices);
+    seaMemDeleteBuffers(1, &cdlodInstances);
+    cdlodVao = cdlodGrid = cdlodIndices = cdlodInstances = 0;
+}
+
+float seaCdlodMorph(float distance, float size, float lodBias)
+{
+    // a leaf of size s exists while its parent (2s) is split, up to
+    // lodBias * 2s / sqrt(2) from the parent's centre (needsSubdivision() of
+    // SurfaceNode.cpp). When the parent splits, the grandparent's centre is
+    // at most sqrt(2) s further, under (lodBias + 1) / sqrt(2) parent sizes:
+    // the parent was not morphed yet, and its children start fully morphed.
+    float end   = lodBias * std::sqrt(2.0f);
+    float start = (lodBias + 1.0f) / std::sqrt(2.0f);
+    return std::min(std::max((distance / size - start) / (end - start), 0.0f), 1.0f);
+}
+
+void seaCdlodDraw(const SeaCdlodInstance* instances, int count)
+{
+    count = std::min(std::max(count, 0), SEA_TESS_MAX_PATCHES);
+
+    // orphan last frame's storage, the GPU may still be reading it
+    glBindBuffer(GL_ARRAY_BUFFER, cdlodInstances);
+    seaMemBufferData(cdlodInstances, GL_ARRAY_BUFFER, SEA_TESS_MAX_PATCHES * sizeof(SeaCdlodInstance), NULL,
+                     GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(SeaCdlodInstance), instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindVertexArray(cdlodVao);
+    glDrawElementsInstanced(GL_TRIANGLES, cdlodIndexCount, GL_UNSIGNED_INT, NULL, count);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,56 @@
+#pragma once
+// Sea without tessellation stages, in the manner of CDLOD (continuous
+// distance-dependent level of detail): every leaf of the SurfaceNode
+// quadtree draws the same SEA_CDLOD_GRID x SEA_CDLOD_GRID grid in one
+// instanced call, and Nuanceurs/seaCdlodSommets.glsl morphs its vertices
+// towards the parent's grid as the distance nears the one where the parent
+// would no longer be split. For drivers where GL_PATCHES are slow or missing.
+//
+// The morph of a leaf is computed on the CPU from the distance
+// needsSubdivision() measures to its parent's centre, so it is complete when
+// the leaf merges into its parent. It starts where the parent's own morph is
+// sure to be 0 when the parent splits, so splits don't move vertices either.
+//
+// Seams need neighbouring leaves at most one level apart, which the quadtree
+// keeps with a bias of at least SEA_LOD_BIAS_MIN (SeaLod.h). The vertices of
+// an edge along a larger neighbour are fully morphed, along a smaller one not
+// at all, and along one of the same size take the larger of both morphs.
+// That last rule can still move the odd vertices of an edge when a leaf
+// beside it splits.
+
+#include <glm/glm.hpp>
+
+// Sea renderers (CVar::seaRenderer)
+#define SEA_RENDER_TESS 0
+#define SEA_RENDER_CDLOD 1
+#define SEA_RENDER_CLIPMAP 2 // SeaClipmap.h
+
+// quads a side of the grid drawn per leaf, even
+#define SEA_CDLOD_GRID 32
+
+/// Per instance attributes, one per quadtree leaf
+struct SeaCdlodInstance
+{
+    glm::vec4 bounds; // centre x, centre z, size, rest height (model space)
+    glm::vec4 sides;  // morph of the vertices on each edge: +z, +x, -z, -x
+    float     morph;  // morph of the other vertices, 0 full grid to 1 parent's grid
+};
+
+/// Creates the grid and the instance buffer. Needs a GL context.
+void seaCdlodInit();
+void seaCdlodShutdown();
+
+/**
+* Morph of a leaf of the given size whose parent's centre is at distance
+* (horizontal, as in needsSubdivision()) from the camera. lodBias is the
+* seaLodBias() the quadtree was built with: the morph ends at
+* lodBias * sqrt(2) * size, where the parent stops being split, and starts
+* at (lodBias + 1) / sqrt(2) * size.
+*/
+float seaCdlodMorph(float distance, float size, float lodBias);
+
+/**
+* Draws count (<= SEA_TESS_MAX_PATCHES) leaves with the active program,
+* whose uniforms are already set.
+*/
+void seaCdlodDraw(const SeaCdlodInstance* instances, int count);
@@ -0,0 +1,130 @@
+// Geometry clipmap sea, see SeaClipmap.h.
+
+#include <cmath>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "SeaClipmap.h"
+#include "SeaMemory.h"
+
+#define SEA_CLIPMAP_SIZE (4 * SEA_CLIPMAP_BLOCK)
+
+static GLuint  clipmapVao        = 0;
+static GLuint  clipmapGrid       = 0;
+static GLuint  clipmapIndices    = 0;
+static GLuint  clipmapOffsets    = 0;
+static GLsizei clipmapIndexCount = 0;
+
+void seaClipmapInit()
+{
+    const int n = SEA_CLIPMAP_BLOCK;
+
+    // block vertices in cells, from 0 to SEA_CLIPMAP_BLOCK
+    std::vector<glm::vec2> vertices;
+    vertices.reserve((n + 1) * (n + 1));
+    for (int j = 0; j <= n; j++)
+    {
+        for (int i = 0; i <= n; i++)
+            vertices.push_back(glm::vec2(static_cast<float>(i), static_cast<float>(j)));
+    }
+
+    // same diagonal everywhere, the way the odd vertices slide (see SeaCdlod.cpp)
+    std::vector<GLuint> indices;
+    indices.reserve(n * n * 6);
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            GLuint a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+            GLuint quad[6] = { a, b, d, a, d, c };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+    clipmapIndexCount = static_cast<GLsizei>(indices.size());
+
+    // block offsets in cells: the 12 of the ring first, then the 4 of the hole
+    std::vector<glm::vec2> offsets;
+    for (int bj = 0; bj < 4; bj++)
+    {
+        for (int bi = 0; bi < 4; bi++)
+        {
+            if (bi == 0 || bi == 3 || bj == 0 || bj == 3)
+                offsets.push_back(glm::vec2(static_cast<float>(bi * n), static_cast<float>(bj * n)));
+        }
+    }
+    for (int bj = 1; bj < 3; bj++)
+    {
+        for (int bi = 1; bi < 3; bi++)
+            offsets.push_back(glm::vec2(static_cast<float>(bi * n), static_cast<float>(bj * n)));
+    }
+
+    seaMemGenVertexArrays(SeaMemBuffers, 1, &clipmapVao);
+    glBindVertexArray(clipmapVao);
+
+    seaMemGenBuffers(SeaMemBuffers, 1, &clipmapGrid);
+    glBindBuffer(GL_ARRAY_BUFFER, clipmapGrid);
+    seaMemBufferData(clipmapGrid, GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(),
+                     GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(0);
+
+    seaMemGenBuffers(SeaMemBuffers, 1, &clipmapOffsets);
+    glBindBuffer(GL_ARRAY_BUFFER, clipmapOffsets);
+    seaMemBufferData(clipmapOffsets, GL_ARRAY_BUFFER, offsets.size() * sizeof(glm::vec2), offsets.data(),
+                     GL_STATIC_DRAW);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(1);
+
+    seaMemGenBuffers(SeaMemBuffers, 1, &clipmapIndices);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, clipmapIndices);
+    seaMemBufferData(clipmapIndices, GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(),
+                     GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void seaClipmapShutdown()
+{
+    seaMemDeleteVertexArrays(1, &clipmapVao);
+    seaMemDeleteBuffers(1, &clipmapGrid);
+    seaMemDeleteBuffers(1, &clipmapIndices);
+    seaMemDeleteBuffers(1, &clipmapOffsets);
+    clipmapVao = clipmapGrid = clipmapIndices = clipmapOffsets = 0;
+}
+
+glm::vec2 seaClipmapCorner(const glm::vec3& cam_position, int level)
+{
+    // the finest level, snapped to the coarsest cell: every level then has
+    // the same centre, and each border falls on the next level's vertices
+    float     coarsest = SEA_CLIPMAP_CELL * static_cast<float>(1 << (SEA_CLIPMAP_LEVELS - 1));
+    glm::vec2 centre   = glm::floor(glm::vec2(cam_position.x, cam_position.z) / coarsest + 0.5f) * coarsest;
+
+    float cell = SEA_CLIPMAP_CELL * static_cast<float>(1 << level);
+    return centre - 0.5f * SEA_CLIPMAP_SIZE * cell;
+}
+
+void seaClipmapDraw(unsigned prog, const glm::vec3& cam_position)
+{
+    GLint cornerLoc = glGetUniformLocation(prog, "clipmapCorner");
+    GLint cellLoc   = glGetUniformLocation(prog, "clipmapCell");
+    glUniform1i(glGetUniformLocation(prog, "clipmapMorph"), SEA_CLIPMAP_MORPH);
+
+    glBindVertexArray(clipmapVao);
+    for (int level = 0; level < SEA_CLIPMAP_LEVELS; level++)
+    {
+        glm::vec2 corner = seaClipmapCorner(cam_position, level);
+        glUniform2f(cornerLoc, corner.x, corner.y);
+        glUniform1f(cellLoc, SEA_CLIPMAP_CELL * static_cast<float>(1 << level));
+        glDrawElementsInstanced(GL_TRIANGLES, clipmapIndexCount, GL_UNSIGNED_INT, NULL, level == 0 ? 16 : 12);
+    }
+    glBindVertexArray(0);
+}
+
+int seaClipmapBlocks()
+{
+    return 16 + 12 * (SEA_CLIPMAP_LEVELS - 1);
+}
@@ -0,0 +1,44 @@
+#pragma once
+// Geometry clipmap sea: SEA_CLIPMAP_LEVELS nested square rings centred on
+// the camera, each twice as coarse and twice as large as the one inside it,
+// drawn with Nuanceurs/seaClipmapSommets.glsl and the usual fragment shader.
+// The cost depends on the number of rings only, not on the view range: no
+// quadtree to rebuild, one instanced draw of a static block mesh per ring.
+//
+// A level is SEA_CLIPMAP_BLOCK * 4 cells a side, made of 4 x 4 blocks: the
+// finest level draws all 16, the others the 12 around the hole the finer
+// level fills. Levels are snapped to the coarsest cell size so every border
+// lies on the vertices of the next level. The vertices near the outer border
+// of a level morph onto the coarser grid, so the seams match without cracks
+// or popping.
+//
+// The waves come from the active model, like the other renderers. For the
+// noise model that is the camera-centred displacement map of SeaMap.h, whose
+// levels cover the same areas.
+
+#include <glm/glm.hpp>
+
+#define SEA_CLIPMAP_LEVELS 6
+// cells a side of a block; a multiple of 2^(SEA_CLIPMAP_LEVELS - 1) so the
+// levels nest on each other's grids
+#define SEA_CLIPMAP_BLOCK 32
+// metres per cell of the finest level: it covers SEA_MAP_EXTENT metres
+#define SEA_CLIPMAP_CELL 0.5f
+// cells, from the outer border of a level, over which it morphs to the coarser grid
+#define SEA_CLIPMAP_MORPH 8
+
+/// Creates the block mesh and the instance offsets. Needs a GL context.
+void seaClipmapInit();
+void seaClipmapShutdown();
+
+/// Lower corner (model space x, z) of level "level" for a camera at cam_position.
+glm::vec2 seaClipmapCorner(const glm::vec3& cam_position, int level);
+
+/**
+* Draws every level around cam_position with the active program prog, whose
+* other uniforms (matrices, waves, lights) are already set.
+*/
+void seaClipmapDraw(unsigned prog, const glm::vec3& cam_position);
+
+/// Blocks drawn by seaClipmapDraw(): a constant.
+int seaClipmapBlocks();
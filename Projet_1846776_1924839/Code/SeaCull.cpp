@@ -0,0 +1,82 @@
+// Per-patch frustum culling counters, see SeaCull.h.
+
+#include "SeaCull.h"
+#include "SeaMemory.h"
+#include "Var.h"
+
+static GLuint cullBuffers[SEA_CULL_BUFFERS] = { 0 };
+static long   cullFrame                     = 0;
+static int    cullCulled                    = -1;
+static bool   cullCounter                   = false;
+
+bool seaCullCounterSupported()
+{
+    GLint counters = 0;
+    glGetIntegerv(GL_MAX_TESS_CONTROL_ATOMIC_COUNTERS, &counters);
+    return counters > 0;
+}
+
+void seaCullInit()
+{
+    cullCounter = seaCullCounterSupported();
+    cullFrame   = 0;
+    cullCulled  = -1;
+    if (!cullCounter)
+        return;
+
+    GLuint zero = 0;
+    seaMemGenBuffers(SeaMemBuffers, SEA_CULL_BUFFERS, cullBuffers);
+    for (int i = 0; i < SEA_CULL_BUFFERS; i++)
+    {
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, cullBuffers[i]);
+        seaMemBufferData(cullBuffers[i], GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), &zero, GL_DYNAMIC_READ);
+    }
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+}
+
+void seaCullShutdown()
+{
+    if (cullCounter)
+        seaMemDeleteBuffers(SEA_CULL_BUFFERS, cullBuffers);
+    cullCounter = false;
+}
+
+void seaCullBind(GLuint prog, const glm::vec3& bounds)
+{
+    glUniform1i(glGetUniformLocation(prog, "cullOn"), CVar::seaCullOn);
+    glUniform3fv(glGetUniformLocation(prog, "displacementBounds"), 1, &bounds[0]);
+
+    if (cullCounter)
+    {
+        GLuint buffer = cullBuffers[cullFrame % SEA_CULL_BUFFERS];
+        GLuint zero   = 0;
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, buffer);
+        glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &zero);
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+        glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, SEA_CULL_BINDING, buffer);
+    }
+}
+
+void seaCullEndFrame()
+{
+    cullFrame++;
+    if (!cullCounter)
+        return;
+
+    // atomic counter writes are incoherent, make them visible to buffer reads
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    if (cullFrame < SEA_CULL_BUFFERS)
+        return;
+
+    // the buffer cleared next frame was written SEA_CULL_BUFFERS - 1 frames ago
+    GLuint culled = 0;
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, cullBuffers[cullFrame % SEA_CULL_BUFFERS]);
+    glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &culled);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+    cullCulled = static_cast<int>(culled);
+}
+
+int seaCullCulledPatches()
+{
+    return cullCulled;
+}
@@ -0,0 +1,35 @@
+#pragma once
+// Per-patch frustum culling in nuanceurTessCtrl.glsl. The TCS bounds each
+// patch with its displacement range and sets every tessellation level to 0
+// when the box is outside one of the frustum planes, so nothing of the patch
+// reaches the evaluation shader. Culled patches are counted by an atomic
+// counter, read back a few frames late so the CPU never waits.
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// atomic counter buffer binding point, injected in the TCS as SEA_CULL_BINDING
+#define SEA_CULL_BINDING 0
+// counter buffers in flight
+#define SEA_CULL_BUFFERS 3
+
+/// Can the TCS use an atomic counter on this GL implementation?
+/// (GL_MAX_TESS_CONTROL_ATOMIC_COUNTERS may be 0.) Needs a GL context.
+bool seaCullCounterSupported();
+
+/// Creates the counter buffers. Needs a GL context.
+void seaCullInit();
+void seaCullShutdown();
+
+/**
+* Sets the culling uniforms of the active program prog. bounds is how far
+* the waves can move the surface: horizontal reach, lowest and highest
+* vertical displacement, in metres. Also binds and clears this frame's counter.
+*/
+void seaCullBind(GLuint prog, const glm::vec3& bounds);
+
+/// Reads the oldest counter. Call once per frame after the sea is drawn.
+void seaCullEndFrame();
+
+/// Patches culled by the TCS, SEA_CULL_BUFFERS - 1 frames ago (-1 without counter).
+int seaCullCulledPatches();
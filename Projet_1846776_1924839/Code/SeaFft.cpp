@@ -0,0 +1,651 @@
+// Spectral (Tessendorf) ocean on the CPU, see SeaFft.h.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "SeaFft.h"
+#include "SeaMemory.h"
+#include "ThreadPool.h"
+
+#define SEA_FFT_GRAVITY 9.81
+#define SEA_FFT_PI 3.14159265358979323846
+
+// Loop period of the animation (s). The dispersion is quantised to multiples
+// of 2 pi / SEA_FFT_LOOP so e^{iwt} comes from one small table per frame.
+#define SEA_FFT_LOOP 200.0
+
+// Columns handled together by the kernels: one AVX2 register
+#define SEA_FFT_LANES 8
+
+/// Float array aligned on 32 bytes for the aligned SIMD loads of the kernels
+struct SeaFftArray
+{
+    std::vector<float> storage;
+    float*             data;
+
+    SeaFftArray() : data(NULL) {}
+
+    void resize(size_t n)
+    {
+        storage.assign(n + 8, 0.0f);
+        size_t misalign = reinterpret_cast<uintptr_t>(storage.data()) % 32;
+        data            = storage.data() + (misalign ? (32 - misalign) / sizeof(float) : 0);
+    }
+};
+
+static SeaFftParams fftParams;
+static SeaFftPlan   fftPlan;
+static CThreadPool* fftPool = NULL;
+
+// Frequencies are stored transposed, [x * N + z], so the 2D inverse FFT
+// (which transposes once) gives the patch back in row-major order.
+
+// spectrum at t = 0, quantised dispersion w = n * 2 pi / SEA_FFT_LOOP
+static std::vector<float> h0Re, h0Im;
+static std::vector<int>   omegaSteps;
+static std::vector<float> phaseCos, phaseSin;
+
+// wave vector, and its direction kx / |k|, kz / |k|
+static std::vector<float> kxs, kzs;
+static std::vector<float> dirX, dirZ;
+
+// H(k, t), the field being transformed, its transpose and the kernel scratch
+static SeaFftArray spectrumRe, spectrumIm;
+static SeaFftArray fieldRe, fieldIm;
+static SeaFftArray transRe, transIm;
+static SeaFftArray tmpRe, tmpIm;
+
+// patch in row-major order (z rows, x columns)
+static std::vector<float> displacements; // dx, h, dz, 0
+static std::vector<float> slopes;        // dh/dx, dh/dz
+
+static glm::vec3 fftBounds(0.0f);
+
+static GLuint displacementTex = 0;
+static GLuint slopeTex        = 0;
+static int    textureSize     = 0;
+
+SeaFftParams seaFftDefaultParams()
+{
+    SeaFftParams params;
+    params.size          = 256;
+    params.patchSize     = 250.0f;
+    params.windSpeed     = 10.0f;
+    params.windDirection = 0.0f;
+    params.fetch         = 100000.0f;
+    params.choppiness    = 1.0f;
+    params.spectrum      = SeaSpectrumJonswap;
+    params.seed          = 1337u;
+    return params;
+}
+
+void seaFftPlanCreate(size_t n, SeaFftPlan& plan)
+{
+    plan.size = n;
+    plan.stages.clear();
+    plan.twiddleRe.clear();
+    plan.twiddleIm.clear();
+
+    size_t s = 1;
+    while (n > 1)
+    {
+        SeaFftStage stage;
+        stage.radix   = n % 4 == 0 ? 4 : 2;
+        stage.n       = n;
+        stage.s       = s;
+        stage.twiddle = plan.twiddleRe.size();
+
+        // w = e^{+2 pi i / n}: inverse transform
+        size_t m = n / stage.radix;
+        for (size_t p = 0; p < m; p++)
+        {
+            for (int r = 1; r < stage.radix; r++)
+            {
+                double angle = 2.0 * SEA_FFT_PI * static_cast<double>(p * r) / static_cast<double>(n);
+                plan.twiddleRe.push_back(static_cast<float>(std::cos(angle)));
+                plan.twiddleIm.push_back(static_cast<float>(std::sin(angle)));
+            }
+        }
+
+        plan.stages.push_back(stage);
+        n /= stage.radix;
+        s *= stage.radix;
+    }
+}
+
+/**
+* Directional wave spectrum per unit of wave vector area (m^4), with a
+* one-sided cos^2 spreading so the waves travel downwind.
+*/
+static double spectrumDensity(double kx, double kz)
+{
+    const double g = SEA_FFT_GRAVITY;
+    const double U = fftParams.windSpeed;
+
+    double k = std::sqrt(kx * kx + kz * kz);
+    if (k < 1e-6)
+        return 0.0;
+
+    double cosTheta = (kx * std::cos(fftParams.windDirection) + kz * std::sin(fftParams.windDirection)) / k;
+    if (cosTheta <= 0.0)
+        return 0.0;
+    double spreading = 2.0 / SEA_FFT_PI * cosTheta * cosTheta;
+
+    if (fftParams.spectrum == SeaSpectrumPhillips)
+    {
+        // Phillips constant 0.0081, largest waves L = U^2 / g, capillary cut-off l = L / 1000
+        double L = U * U / g;
+        double l = L * 0.001;
+        return 0.0081 * 0.5 / (k * k * k * k) * std::exp(-1.0 / (k * k * L * L)) * std::exp(-k * k * l * l) *
+               spreading;
+    }
+
+    // JONSWAP in frequency, converted to wave vector with dw/dk = g / 2w
+    double F      = fftParams.fetch;
+    double omega  = std::sqrt(g * k);
+    double omegaP = 22.0 * std::pow(g * g / (U * F), 1.0 / 3.0);
+    double alpha  = 0.076 * std::pow(U * U / (F * g), 0.22);
+    double sigma  = omega <= omegaP ? 0.07 : 0.09;
+    double r      = std::exp(-(omega - omegaP) * (omega - omegaP) / (2.0 * sigma * sigma * omegaP * omegaP));
+    double S      = alpha * g * g / std::pow(omega, 5.0) * std::exp(-1.25 * std::pow(omegaP / omega, 4.0)) *
+               std::pow(3.3, r);
+    return S * (g / (2.0 * omega)) / k * spreading;
+}
+
+/// Standard normal sample (Box-Muller on mt19937, the same on every platform)
+static double gaussian(std::mt19937& rng)
+{
+    double u1 = (static_cast<double>(rng()) + 1.0) / 4294967296.0;
+    double u2 = static_cast<double>(rng()) / 4294967296.0;
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * SEA_FFT_PI * u2);
+}
+
+void seaFftInit(const SeaFftParams& params, unsigned nThreads)
+{
+    delete fftPool;
+    fftParams = params;
+    fftPool   = new CThreadPool(nThreads);
+
+    const size_t N  = static_cast<size_t>(params.size);
+    const double dk = 2.0 * SEA_FFT_PI / params.patchSize;
+    seaFftPlanCreate(N, fftPlan);
+
+    kxs.resize(N);
+    kzs.resize(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        // FFT order: 0, 1, ..., N/2 - 1, -N/2, ..., -1
+        double n = i < N / 2 ? static_cast<double>(i) : static_cast<double>(i) - static_cast<double>(N);
+        kxs[i]   = static_cast<float>(n * dk);
+        kzs[i]   = static_cast<float>(n * dk);
+    }
+
+    h0Re.assign(N * N, 0.0f);
+    h0Im.assign(N * N, 0.0f);
+    omegaSteps.assign(N * N, 0);
+    dirX.assign(N * N, 0.0f);
+    dirZ.assign(N * N, 0.0f);
+
+    const double omegaStep = 2.0 * SEA_FFT_PI / SEA_FFT_LOOP;
+    int          maxStep   = 0;
+
+    std::mt19937 rng(params.seed);
+    for (size_t z = 0; z < N; z++)
+    {
+        for (size_t x = 0; x < N; x++)
+        {
+            size_t i  = x * N + z;
+            double kx = kxs[x];
+            double kz = kzs[z];
+            double k  = std::sqrt(kx * kx + kz * kz);
+
+            double xi1 = gaussian(rng);
+            double xi2 = gaussian(rng);
+
+            // the Nyquist row and column have no -k partner, leave them empty
+            if (x == N / 2 || z == N / 2 || k == 0.0)
+                continue;
+
+            double amplitude = std::sqrt(spectrumDensity(kx, kz) * dk * dk * 0.5);
+            h0Re[i]          = static_cast<float>(xi1 * amplitude);
+            h0Im[i]          = static_cast<float>(xi2 * amplitude);
+            dirX[i]          = static_cast<float>(kx / k);
+            dirZ[i]          = static_cast<float>(kz / k);
+
+            // deep water: w^2 = g k
+            omegaSteps[i] = static_cast<int>(std::sqrt(SEA_FFT_GRAVITY * k) / omegaStep);
+            maxStep       = std::max(maxStep, omegaSteps[i]);
+        }
+    }
+    phaseCos.assign(maxStep + 1, 1.0f);
+    phaseSin.assign(maxStep + 1, 0.0f);
+
+    spectrumRe.resize(N * N);
+    spectrumIm.resize(N * N);
+    fieldRe.resize(N * N);
+    fieldIm.resize(N * N);
+    transRe.resize(N * N);
+    transIm.resize(N * N);
+    tmpRe.resize(N * N);
+    tmpIm.resize(N * N);
+
+    displacements.assign(N * N * 4, 0.0f);
+    slopes.assign(N * N * 2, 0.0f);
+}
+
+void seaFftShutdown()
+{
+    delete fftPool;
+    fftPool = NULL;
+
+    if (displacementTex)
+    {
+        seaMemDeleteTextures(1, &displacementTex);
+        seaMemDeleteTextures(1, &slopeTex);
+    }
+    displacementTex = 0;
+    slopeTex        = 0;
+    textureSize     = 0;
+}
+
+const SeaFftParams& seaFftParams()
+{
+    return fftParams;
+}
+
+static void parallelRows(const std::function<void(size_t, size_t)>& fn)
+{
+    fftPool->parallelFor(fftPlan.size, 8, fn);
+}
+
+/// Inverse FFT of every column of (re, im), SEA_FFT_LANES columns per task
+static void columnPass(SeaNoiseIsa isa, float* re, float* im)
+{
+    const size_t N      = fftPlan.size;
+    const size_t groups = N / SEA_FFT_LANES;
+    const size_t grain  = std::max<size_t>(1, groups / (2 * fftPool->nbThreads()));
+
+    fftPool->parallelFor(groups, grain, [&](size_t begin, size_t end) {
+        size_t b0 = begin * SEA_FFT_LANES;
+        size_t b1 = end * SEA_FFT_LANES;
+        switch (isa)
+        {
+        case SeaNoiseAVX2:
+            seaFftKernelAVX2(fftPlan, re, im, tmpRe.data, tmpIm.data, N, b0, b1);
+            break;
+        case SeaNoiseSSE4:
+            seaFftKernelSSE4(fftPlan, re, im, tmpRe.data, tmpIm.data, N, b0, b1);
+            break;
+        default:
+            seaFftKernelScalar(fftPlan, re, im, tmpRe.data, tmpIm.data, N, b0, b1);
+            break;
+        }
+    });
+}
+
+/// dst = transpose(src), in 16 x 16 blocks to stay in cache
+static void transpose(const float* src, float* dst)
+{
+    const size_t N = fftPlan.size;
+    fftPool->parallelFor(N / 16, 1, [&](size_t begin, size_t end) {
+        for (size_t bz = begin * 16; bz < end * 16; bz += 16)
+            for (size_t bx = 0; bx < N; bx += 16)
+                for (size_t z = bz; z < bz + 16; z++)
+                    for (size_t x = bx; x < bx + 16; x++)
+                        dst[x * N + z] = src[z * N + x];
+    });
+}
+
+/**
+* 2D inverse FFT of (fieldRe, fieldIm) into (transRe, transIm): along the
+* columns, transpose, along the columns again. The result is the transpose
+* of the input layout, so frequencies stored [x * N + z] give a patch [z * N + x].
+*/
+static void inverse2d(SeaNoiseIsa isa)
+{
+    columnPass(isa, fieldRe.data, fieldIm.data);
+    transpose(fieldRe.data, transRe.data);
+    transpose(fieldIm.data, transIm.data);
+    columnPass(isa, transRe.data, transIm.data);
+}
+
+void seaFftUpdate(float t, SeaNoiseIsa isa)
+{
+    SeaNoiseIsa best = seaNoiseBestIsa();
+    if (isa == SeaNoiseAuto || isa > best)
+        isa = best;
+
+    const size_t N = fftPlan.size;
+
+    // e^{i n w0 t} for every dispersion step, t wrapped in double so the
+    // phase stays exact however long the application runs
+    double loopTime = std::fmod(static_cast<double>(t), SEA_FFT_LOOP);
+    for (size_t n = 0; n < phaseCos.size(); n++)
+    {
+        double phase = 2.0 * SEA_FFT_PI / SEA_FFT_LOOP * static_cast<double>(n) * loopTime;
+        phaseCos[n]  = static_cast<float>(std::cos(phase));
+        phaseSin[n]  = static_cast<float>(std::sin(phase));
+    }
+
+    // H(k, t) = h0(k) e^{iwt} + conj(h0(-k)) e^{-iwt}
+    parallelRows([&](size_t begin, size_t end) {
+        for (size_t x = begin; x < end; x++)
+        {
+            size_t mx = (N - x) % N;
+            for (size_t z = 0; z < N; z++)
+            {
+                size_t i = x * N + z;
+                size_t j = mx * N + (N - z) % N;
+                float  c = phaseCos[omegaSteps[i]];
+                float  s = phaseSin[omegaSteps[i]];
+
+                spectrumRe.data[i] = (h0Re[i] + h0Re[j]) * c - (h0Im[i] + h0Im[j]) * s;
+                spectrumIm.data[i] = (h0Re[i] - h0Re[j]) * s + (h0Im[i] - h0Im[j]) * c;
+            }
+        }
+    });
+
+    // Each field has a real transform, so two of them share one complex
+    // FFT: F1 + i F2 comes back as f1 + i f2.
+    for (int pass = 0; pass < 3; pass++)
+    {
+        parallelRows([&](size_t begin, size_t end) {
+            for (size_t x = begin; x < end; x++)
+            {
+                for (size_t z = 0; z < N; z++)
+                {
+                    size_t i  = x * N + z;
+                    float  hr = spectrumRe.data[i];
+                    float  hi = spectrumIm.data[i];
+                    float  kx = kxs[x];
+                    float  kz = kzs[z];
+                    float  nx = dirX[i];
+                    float  nz = dirZ[i];
+
+                    if (pass == 0)
+                    {
+                        // height + i * slope x (i kx H)
+                        fieldRe.data[i] = hr - kx * hr;
+                        fieldIm.data[i] = hi - kx * hi;
+                    }
+                    else if (pass == 1)
+                    {
+                        // slope z (i kz H) + i * displacement x (-i kx/k H)
+                        fieldRe.data[i] = -kz * hi + nx * hr;
+                        fieldIm.data[i] = kz * hr + nx * hi;
+                    }
+                    else
+                    {
+                        // displacement z (-i kz/k H)
+                        fieldRe.data[i] = nz * hi;
+                        fieldIm.data[i] = -nz * hr;
+                    }
+                }
+            }
+        });
+
+        inverse2d(isa);
+
+        parallelRows([&](size_t begin, size_t end) {
+            for (size_t z = begin; z < end; z++)
+            {
+                for (size_t x = 0; x < N; x++)
+                {
+                    size_t i = z * N + x;
+                    if (pass == 0)
+                    {
+                        displacements[4 * i + 1] = transRe.data[i];
+                        slopes[2 * i]            = transIm.data[i];
+                    }
+                    else if (pass == 1)
+                    {
+                        slopes[2 * i + 1]        = transRe.data[i];
+                        displacements[4 * i + 0] = transIm.data[i];
+                    }
+                    else
+                    {
+                        displacements[4 * i + 2] = transRe.data[i];
+                    }
+                }
+            }
+        });
+    }
+
+    float reach = 0.0f, low = 0.0f, high = 0.0f;
+    for (size_t i = 0; i < displacements.size(); i += 4)
+    {
+        reach = std::max(reach, std::max(std::fabs(displacements[i]), std::fabs(displacements[i + 2])));
+        low   = std::min(low, displacements[i + 1]);
+        high  = std::max(high, displacements[i + 1]);
+    }
+    fftBounds = glm::vec3(reach * fftParams.choppiness, low, high);
+}
+
+void seaFftUpload()
+{
+    const int N = fftParams.size;
+    if (textureSize != N)
+    {
+        if (displacementTex)
+        {
+            seaMemDeleteTextures(1, &displacementTex);
+            seaMemDeleteTextures(1, &slopeTex);
+        }
+
+        seaMemGenTextures(SeaMemTextures, 1, &displacementTex);
+        glBindTexture(GL_TEXTURE_2D, displacementTex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, N, N);
+        seaMemTextureSize(displacementTex, 16LL * N * N);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+        seaMemGenTextures(SeaMemTextures, 1, &slopeTex);
+        glBindTexture(GL_TEXTURE_2D, slopeTex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32F, N, N);
+        seaMemTextureSize(slopeTex, 8LL * N * N);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+        textureSize = N;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, displacementTex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, N, N, GL_RGBA, GL_FLOAT, displacements.data());
+    glBindTexture(GL_TEXTURE_2D, slopeTex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, N, N, GL_RG, GL_FLOAT, slopes.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void seaFftBind(GLuint prog, GLint unitDisplacement, GLint unitSlope)
+{
+    glActiveTexture(GL_TEXTURE0 + unitDisplacement);
+    glBindTexture(GL_TEXTURE_2D, displacementTex);
+    glActiveTexture(GL_TEXTURE0 + unitSlope);
+    glBindTexture(GL_TEXTURE_2D, slopeTex);
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform1i(glGetUniformLocation(prog, "seaFftDisplacement"), unitDisplacement);
+    glUniform1i(glGetUniformLocation(prog, "seaFftSlope"), unitSlope);
+    glUniform1f(glGetUniformLocation(prog, "seaFftPatchSize"), fftParams.patchSize);
+    glUniform1f(glGetUniformLocation(prog, "seaFftChoppiness"), fftParams.choppiness);
+}
+
+float seaFftHeight(float x, float z)
+{
+    const int N = fftParams.size;
+    if (displacements.empty())
+        return 0.0f;
+
+    // sample (i, j) sits at (i, j) * patchSize / N, like the texture in the TES
+    float fx = x / fftParams.patchSize * N;
+    float fz = z / fftParams.patchSize * N;
+    float x0 = std::floor(fx);
+    float z0 = std::floor(fz);
+    float ax = fx - x0;
+    float az = fz - z0;
+
+    int i0 = ((static_cast<int>(x0) % N) + N) % N;
+    int j0 = ((static_cast<int>(z0) % N) + N) % N;
+    int i1 = (i0 + 1) % N;
+    int j1 = (j0 + 1) % N;
+
+    float h00 = displacements[4 * (j0 * N + i0) + 1];
+    float h10 = displacements[4 * (j0 * N + i1) + 1];
+    float h01 = displacements[4 * (j1 * N + i0) + 1];
+    float h11 = displacements[4 * (j1 * N + i1) + 1];
+    return (h00 * (1.0f - ax) + h10 * ax) * (1.0f - az) + (h01 * (1.0f - ax) + h11 * ax) * az;
+}
+
+glm::vec3 seaFftBounds()
+{
+    return fftBounds;
+}
+
+/**
+* Direct separable inverse DFT in double precision, reference for the kernels.
+* data is row-major, the result is returned in the same (non transposed) layout.
+*/
+static void directInverse2d(size_t N, std::vector<double>& re, std::vector<double>& im)
+{
+    std::vector<double> c(N), s(N), rowRe(N), rowIm(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        c[i] = std::cos(2.0 * SEA_FFT_PI * static_cast<double>(i) / static_cast<double>(N));
+        s[i] = std::sin(2.0 * SEA_FFT_PI * static_cast<double>(i) / static_cast<double>(N));
+    }
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (size_t line = 0; line < N; line++)
+        {
+            // pass 0 along x (rows), pass 1 along z (columns)
+            size_t base   = pass == 0 ? line * N : line;
+            size_t stride = pass == 0 ? 1 : N;
+            for (size_t k = 0; k < N; k++)
+            {
+                double sr = 0.0, si = 0.0;
+                for (size_t n = 0; n < N; n++)
+                {
+                    size_t w = (n * k) % N;
+                    double a = re[base + n * stride];
+                    double b = im[base + n * stride];
+                    sr += a * c[w] - b * s[w];
+                    si += a * s[w] + b * c[w];
+                }
+                rowRe[k] = sr;
+                rowIm[k] = si;
+            }
+            for (size_t k = 0; k < N; k++)
+            {
+                re[base + k * stride] = rowRe[k];
+                im[base + k * stride] = rowIm[k];
+            }
+        }
+    }
+}
+
+void seaFftBenchmark()
+{
+    SeaFftParams params = seaFftDefaultParams();
+    unsigned     maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // accuracy of every kernel against the direct DFT
+    {
+        const size_t N = 128;
+        params.size    = static_cast<int>(N);
+        seaFftInit(params, 1);
+
+        std::mt19937        rng(7u);
+        std::vector<double> refRe(N * N), refIm(N * N);
+        for (size_t i = 0; i < N * N; i++)
+        {
+            refRe[i] = gaussian(rng);
+            refIm[i] = gaussian(rng);
+        }
+        std::vector<double> inRe = refRe, inIm = refIm;
+        directInverse2d(N, refRe, refIm);
+
+        double peak = 0.0;
+        for (size_t i = 0; i < N * N; i++)
+            peak = std::max(peak, std::max(std::fabs(refRe[i]), std::fabs(refIm[i])));
+
+        printf("seaFft: inverse FFT %ux%u against a direct DFT\n", static_cast<unsigned>(N),
+               static_cast<unsigned>(N));
+        for (int i = SeaNoiseScalar; i <= seaNoiseBestIsa(); i++)
+        {
+            SeaNoiseIsa isa = static_cast<SeaNoiseIsa>(i);
+            for (size_t k = 0; k < N * N; k++)
+            {
+                fieldRe.data[k] = static_cast<float>(inRe[k]);
+                fieldIm.data[k] = static_cast<float>(inIm[k]);
+            }
+            inverse2d(isa);
+
+            double maxErr = 0.0;
+            for (size_t z = 0; z < N; z++)
+                for (size_t x = 0; x < N; x++)
+                {
+                    size_t t = x * N + z;
+                    maxErr   = std::max(maxErr, std::fabs(transRe.data[t] - refRe[z * N + x]));
+                    maxErr   = std::max(maxErr, std::fabs(transIm.data[t] - refIm[z * N + x]));
+                }
+            printf("  %-8s max error %g (relative %g)\n", seaNoiseIsaName(isa), maxErr, maxErr / peak);
+        }
+    }
+
+    // sea state of the default spectrum
+    params.size = 256;
+    seaFftInit(params, 0);
+    seaFftUpdate(0.0f);
+    double sum = 0.0;
+    for (size_t i = 0; i < displacements.size(); i += 4)
+        sum += static_cast<double>(displacements[i + 1]) * displacements[i + 1];
+    double rms = std::sqrt(sum / (displacements.size() / 4));
+    printf("\nJONSWAP %.0f m/s, fetch %.0f km: rms height %.2f m, significant wave height %.2f m\n",
+           params.windSpeed, params.fetch / 1000.0f, rms, 4.0 * rms);
+
+    // time per update: spectrum + 3 complex 2D inverse FFTs + packing
+    printf("\n%-6s %-8s %8s %14s %14s\n", "size", "isa", "threads", "update ms", "2D IFFT ms");
+    const int sizes[] = { 128, 256, 512 };
+    for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); si++)
+    {
+        unsigned threadCounts[] = { 1, maxThreads };
+        for (int ti = 0; ti < (maxThreads > 1 ? 2 : 1); ti++)
+        {
+            params.size = sizes[si];
+            seaFftInit(params, threadCounts[ti]);
+            int iterations = std::max(4, (1 << 22) / (sizes[si] * sizes[si]));
+
+            for (int i = SeaNoiseScalar; i <= seaNoiseBestIsa(); i++)
+            {
+                SeaNoiseIsa isa = static_cast<SeaNoiseIsa>(i);
+                seaFftUpdate(0.0f, isa);
+
+                auto t0 = std::chrono::steady_clock::now();
+                for (int it = 0; it < iterations; it++)
+                    seaFftUpdate(0.1f * it, isa);
+                auto t1 = std::chrono::steady_clock::now();
+                for (int it = 0; it < iterations; it++)
+                    inverse2d(isa);
+                auto t2 = std::chrono::steady_clock::now();
+
+                double updateMs = std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+                double fftMs    = std::chrono::duration<double, std::milli>(t2 - t1).count() / iterations;
+                printf("%-6d %-8s %8u %14.3f %14.3f\n", sizes[si], seaNoiseIsaName(isa), threadCounts[ti],
+                       updateMs, fftMs);
+            }
+        }
+    }
+
+    seaFftShutdown();
+}
@@ -0,0 +1,104 @@
+#pragma once
+// Spectral (Tessendorf) ocean: a Phillips or JONSWAP wave spectrum animated
+// with the deep water dispersion relation and brought back to a tileable
+// height / slope / choppy displacement patch by inverse FFTs on the CPU.
+// The patch is uploaded every frame and sampled by nuanceurTessEval.glsl
+// when CVar::waveModel is SEA_WAVE_FFT.
+
+#include <cstddef>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "SeaNoise.h"
+
+/// Sea state spectrum
+enum SeaSpectrum
+{
+    SeaSpectrumPhillips,
+    SeaSpectrumJonswap
+};
+
+struct SeaFftParams
+{
+    int         size;          // N, power of two >= 16: the patch is N x N samples
+    float       patchSize;     // metres covered by the patch before it repeats
+    float       windSpeed;     // m/s at 10 m above the sea
+    float       windDirection; // radians, 0 = +x
+    float       fetch;         // metres of open water upwind (JONSWAP)
+    float       choppiness;    // horizontal displacement factor, 0 = none
+    SeaSpectrum spectrum;
+    unsigned    seed;
+};
+
+/// 256 x 256 samples over 250 m, 10 m/s wind along +x, 100 km fetch, JONSWAP.
+SeaFftParams seaFftDefaultParams();
+
+/// Builds the spectrum and the FFT plan. nThreads == 0 uses every hardware thread.
+void seaFftInit(const SeaFftParams& params, unsigned nThreads = 0);
+void seaFftShutdown();
+
+/// Current parameters (after seaFftInit())
+const SeaFftParams& seaFftParams();
+
+/// Animates the spectrum to time t (seconds) and runs the inverse FFTs.
+void seaFftUpdate(float t, SeaNoiseIsa isa = SeaNoiseAuto);
+
+/// Uploads the last seaFftUpdate() to the textures (created on first use).
+void seaFftUpload();
+
+/**
+* Binds the displacement and slope textures on units "unitDisplacement" and
+* "unitSlope" and sets the seaFft* uniforms of the active program prog.
+*/
+void seaFftBind(GLuint prog, GLint unitDisplacement, GLint unitSlope);
+
+/// Wave height of the last seaFftUpdate() at world (x, z), bilinear, no choppiness.
+float seaFftHeight(float x, float z);
+
+/// Displacement range of the last seaFftUpdate(), choppiness included:
+/// (horizontal reach, lowest height, highest height) in metres.
+glm::vec3 seaFftBounds();
+
+/// Times the update at 128^2, 256^2 and 512^2 for every instruction set and
+/// thread count, and checks the FFT against a direct DFT. Printed on stdout.
+void seaFftBenchmark();
+
+/**
+* Stockham FFT plan: radix-4 stages, then one radix-2 stage when log2(N) is
+* odd. Stage "i" splits sub-transforms of length n with a stride of s rows.
+* Twiddles w^p, w^2p, w^3p (radix 4) or w^p (radix 2) for each butterfly p,
+* starting at "twiddle" in twiddleRe / twiddleIm.
+*/
+struct SeaFftStage
+{
+    int    radix;
+    size_t n;
+    size_t s;
+    size_t twiddle;
+};
+
+struct SeaFftPlan
+{
+    size_t                   size;
+    std::vector<SeaFftStage> stages;
+    std::vector<float>       twiddleRe;
+    std::vector<float>       twiddleIm;
+};
+
+/// Plan of an inverse (e^{+i}) transform of length n, a power of two >= 2.
+void seaFftPlanCreate(size_t n, SeaFftPlan& plan);
+
+/**
+* Kernels, one per instruction set (SeaKernels*.cpp). Inverse FFT along the
+* columns [b0, b1) of a row-major re / im array whose rows are rowStride
+* floats apart. tmpRe / tmpIm have the same layout and are used as scratch.
+* b1 - b0 must be a multiple of 8 and the arrays 32 byte aligned.
+*/
+void seaFftKernelScalar(const SeaFftPlan& plan, float* re, float* im, float* tmpRe, float* tmpIm,
+                        size_t rowStride, size_t b0, size_t b1);
+void seaFftKernelSSE4(const SeaFftPlan& plan, float* re, float* im, float* tmpRe, float* tmpIm,
+                      size_t rowStride, size_t b0, size_t b1);
+void seaFftKernelAVX2(const SeaFftPlan& plan, float* re, float* im, float* tmpRe, float* tmpIm,
+                      size_t rowStride, size_t b0, size_t b1);
@@ -0,0 +1,143 @@
+#pragma once
+// SIMD inverse FFT butterflies shared by the per instruction set translation
+// units (SeaKernelsScalar.cpp, SeaKernelsSSE4.cpp, SeaKernelsAVX2.cpp), see
+// SeaKernels.h for the lane types V.
+//
+// The transforms run down the columns of a row-major array, so one lane
+// group handles V::width neighbouring columns and every load is contiguous.
+// A 2D transform is a column pass, a transpose and a second column pass.
+
+#include <cstring>
+
+#include "SeaFft.h"
+
+template <class V>
+inline void seaFftRadix2(const SeaFftStage& stage, const SeaFftPlan& plan, const float* xr, const float* xi,
+                         float* yr, float* yi, size_t rowStride, size_t b0, size_t b1)
+{
+    const size_t m = stage.n / 2;
+    const size_t s = stage.s;
+
+    for (size_t p = 0; p < m; p++)
+    {
+        const V wr(plan.twiddleRe[stage.twiddle + p]);
+        const V wi(plan.twiddleIm[stage.twiddle + p]);
+
+        for (size_t q = 0; q < s; q++)
+        {
+            const size_t ia = (q + s * p) * rowStride;
+            const size_t ib = (q + s * (p + m)) * rowStride;
+            const size_t o0 = (q + s * (2 * p)) * rowStride;
+            const size_t o1 = (q + s * (2 * p + 1)) * rowStride;
+
+            for (size_t b = b0; b < b1; b += V::width)
+            {
+                V ar = V::load(xr + ia + b), ai = V::load(xi + ia + b);
+                V br = V::load(xr + ib + b), bi = V::load(xi + ib + b);
+
+                (ar + br).store(yr + o0 + b);
+                (ai + bi).store(yi + o0 + b);
+
+                V dr = ar - br, di = ai - bi;
+                (dr * wr - di * wi).store(yr + o1 + b);
+                (dr * wi + di * wr).store(yi + o1 + b);
+            }
+        }
+    }
+}
+
+template <class V>
+inline void seaFftRadix4(const SeaFftStage& stage, const SeaFftPlan& plan, const float* xr, const float* xi,
+                         float* yr, float* yi, size_t rowStride, size_t b0, size_t b1)
+{
+    const size_t m = stage.n / 4;
+    const size_t s = stage.s;
+
+    for (size_t p = 0; p < m; p++)
+    {
+        const size_t t = stage.twiddle + 3 * p;
+        const V      w1r(plan.twiddleRe[t]), w1i(plan.twiddleIm[t]);
+        const V      w2r(plan.twiddleRe[t + 1]), w2i(plan.twiddleIm[t + 1]);
+        const V      w3r(plan.twiddleRe[t + 2]), w3i(plan.twiddleIm[t + 2]);
+
+        for (size_t q = 0; q < s; q++)
+        {
+            const size_t ia = (q + s * p) * rowStride;
+            const size_t ib = (q + s * (p + m)) * rowStride;
+            const size_t ic = (q + s * (p + 2 * m)) * rowStride;
+            const size_t id = (q + s * (p + 3 * m)) * rowStride;
+            const size_t o0 = (q + s * (4 * p)) * rowStride;
+            const size_t o1 = (q + s * (4 * p + 1)) * rowStride;
+            const size_t o2 = (q + s * (4 * p + 2)) * rowStride;
+            const size_t o3 = (q + s * (4 * p + 3)) * rowStride;
+
+            for (size_t b = b0; b < b1; b += V::width)
+            {
+                V ar = V::load(xr + ia + b), ai = V::load(xi + ia + b);
+                V br = V::load(xr + ib + b), bi = V::load(xi + ib + b);
+                V cr = V::load(xr + ic + b), ci = V::load(xi + ic + b);
+                V dr = V::load(xr + id + b), di = V::load(xi + id + b);
+
+                V apcR = ar + cr, apcI = ai + ci;
+                V amcR = ar - cr, amcI = ai - ci;
+                V bpdR = br + dr, bpdI = bi + di;
+                // j * (b - d)
+                V jbmdR = di - bi, jbmdI = br - dr;
+
+                (apcR + bpdR).store(yr + o0 + b);
+                (apcI + bpdI).store(yi + o0 + b);
+
+                V x1r = amcR + jbmdR, x1i = amcI + jbmdI;
+                (x1r * w1r - x1i * w1i).store(yr + o1 + b);
+                (x1r * w1i + x1i * w1r).store(yi + o1 + b);
+
+                V x2r = apcR - bpdR, x2i = apcI - bpdI;
+                (x2r * w2r - x2i * w2i).store(yr + o2 + b);
+                (x2r * w2i + x2i * w2r).store(yi + o2 + b);
+
+                V x3r = amcR - jbmdR, x3i = amcI - jbmdI;
+                (x3r * w3r - x3i * w3i).store(yr + o3 + b);
+                (x3r * w3i + x3i * w3r).store(yi + o3 + b);
+            }
+        }
+    }
+}
+
+/**
+* Inverse FFT of the columns [b0, b1). Stockham stages ping-pong between
+* (re, im) and (tmpRe, tmpIm); the result always ends up in (re, im).
+*/
+template <class V>
+inline void seaFftColumns(const SeaFftPlan& plan, float* re, float* im, float* tmpRe, float* tmpIm,
+                          size_t rowStride, size_t b0, size_t b1)
+{
+    float* xr = re;
+    float* xi = im;
+    float* yr = tmpRe;
+    float* yi = tmpIm;
+
+    for (size_t i = 0; i < plan.stages.size(); i++)
+    {
+        const SeaFftStage& stage = plan.stages[i];
+        if (stage.radix == 4)
+            seaFftRadix4<V>(stage, plan, xr, xi, yr, yi, rowStride, b0, b1);
+        else
+            seaFftRadix2<V>(stage, plan, xr, xi, yr, yi, rowStride, b0, b1);
+
+        float* t = xr;
+        xr       = yr;
+        yr       = t;
+        t        = xi;
+        xi       = yi;
+        yi       = t;
+    }
+
+    if (xr != re)
+    {
+        for (size_t row = 0; row < plan.size; row++)
+        {
+            std::memcpy(re + row * rowStride + b0, xr + row * rowStride + b0, (b1 - b0) * sizeof(float));
+            std::memcpy(im + row * rowStride + b0, xi + row * rowStride + b0, (b1 - b0) * sizeof(float));
+        }
+    }
+}
@@ -0,0 +1,179 @@
+// Frame time telemetry, see SeaFrameTime.h.
+
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+
+#include "SeaFrameTime.h"
+#include "Var.h"
+
+struct FrameHistogram
+{
+    unsigned counts[SEA_FRAME_BUCKETS];
+    unsigned total;
+};
+
+static FrameHistogram frameWindow[SeaFrameSeriesCount]                    = {};
+static FrameHistogram frameRun[SeaFrameSeriesCount]                       = {};
+static double         frameRing[SeaFrameSeriesCount][SEA_FRAME_WINDOW]    = {};
+static bool           frameRingSet[SeaFrameSeriesCount][SEA_FRAME_WINDOW] = {};
+static long           frameCount                                          = 0;
+static long           frameRunHitches                                     = 0;
+static double         frameRunMax[SeaFrameSeriesCount]                    = {};
+
+/// Bucket of a value in microseconds.
+static int bucketOf(double ms)
+{
+    long us = std::min(std::max(static_cast<long>(ms * 1000.0), 0L), static_cast<long>(SEA_FRAME_MAX_US) - 1);
+    if (us < SEA_FRAME_SUB_BUCKETS)
+        return static_cast<int>(us);
+
+    // shift bringing the value into [SUB / 2, SUB)
+    int shift = 0;
+    while ((us >> shift) >= SEA_FRAME_SUB_BUCKETS)
+        shift++;
+    return SEA_FRAME_SUB_BUCKETS + (shift - 1) * SEA_FRAME_SUB_BUCKETS / 2
+           + static_cast<int>(us >> shift) - SEA_FRAME_SUB_BUCKETS / 2;
+}
+
+/// Values of a bucket, [low, high) in milliseconds.
+static void bucketRange(int bucket, double& low, double& high)
+{
+    if (bucket < SEA_FRAME_SUB_BUCKETS)
+    {
+        low  = bucket * 1e-3;
+        high = (bucket + 1) * 1e-3;
+        return;
+    }
+    int  k     = bucket - SEA_FRAME_SUB_BUCKETS;
+    int  shift = k / (SEA_FRAME_SUB_BUCKETS / 2) + 1;
+    long sub   = k % (SEA_FRAME_SUB_BUCKETS / 2) + SEA_FRAME_SUB_BUCKETS / 2;
+    low        = (sub << shift) * 1e-3;
+    high       = ((sub + 1) << shift) * 1e-3;
+}
+
+static double percentileOf(const FrameHistogram& h, double percentile)
+{
+    if (h.total == 0)
+        return 0.0;
+    unsigned rank = std::max(1u, static_cast<unsigned>(std::ceil(percentile / 100.0 * h.total)));
+    unsigned seen = 0;
+    double   low, high = 0.0;
+    for (int b = 0; b < SEA_FRAME_BUCKETS; b++)
+    {
+        seen += h.counts[b];
+        if (seen >= rank)
+        {
+            bucketRange(b, low, high);
+            break;
+        }
+    }
+    return high;
+}
+
+void seaFrameTimeAdd(double wallMs, double cpuMs, double gpuMs)
+{
+    const double values[SeaFrameSeriesCount] = { wallMs, cpuMs, gpuMs };
+    int          slot                        = static_cast<int>(frameCount % SEA_FRAME_WINDOW);
+
+    for (int s = 0; s < SeaFrameSeriesCount; s++)
+    {
+        // the frame leaving the window
+        if (frameRingSet[s][slot])
+        {
+            frameWindow[s].counts[bucketOf(frameRing[s][slot])]--;
+            frameWindow[s].total--;
+        }
+        frameRingSet[s][slot] = values[s] >= 0.0;
+        frameRing[s][slot]    = values[s];
+        if (!frameRingSet[s][slot])
+            continue;
+
+        int b = bucketOf(values[s]);
+        frameWindow[s].counts[b]++;
+        frameWindow[s].total++;
+        frameRun[s].counts[b]++;
+        frameRun[s].total++;
+        frameRunMax[s] = std::max(frameRunMax[s], values[s]);
+    }
+
+    if (wallMs > CVar::hitchMs)
+        frameRunHitches++;
+    frameCount++;
+}
+
+double seaFrameTimePercentile(SeaFrameSeries series, double percentile)
+{
+    return percentileOf(frameWindow[series], percentile);
+}
+
+double seaFrameTimeMax(SeaFrameSeries series)
+{
+    double m = 0.0;
+    for (int i = 0; i < SEA_FRAME_WINDOW; i++)
+    {
+        if (frameRingSet[series][i])
+            m = std::max(m, frameRing[series][i]);
+    }
+    return m;
+}
+
+int seaFrameTimeCount()
+{
+    return static_cast<int>(std::min(frameCount, static_cast<long>(SEA_FRAME_WINDOW)));
+}
+
+int seaFrameTimeHitches()
+{
+    int hitches = 0;
+    for (int i = 0; i < SEA_FRAME_WINDOW; i++)
+    {
+        if (frameRingSet[SeaFrameWall][i] && frameRing[SeaFrameWall][i] > CVar::hitchMs)
+            hitches++;
+    }
+    return hitches;
+}
+
+static const char* seriesNames[SeaFrameSeriesCount] = { "image", "CPU", "GPU" };
+
+void seaFrameTimePrint()
+{
+    printf("Temps des %d dernieres images (ms):     p50      p95      p99      max\n", seaFrameTimeCount());
+    for (int s = 0; s < SeaFrameSeriesCount; s++)
+    {
+        SeaFrameSeries series = static_cast<SeaFrameSeries>(s);
+        printf("  %-36s %8.2f %8.2f %8.2f %8.2f\n", seriesNames[s], seaFrameTimePercentile(series, 50.0),
+               seaFrameTimePercentile(series, 95.0), seaFrameTimePercentile(series, 99.0), seaFrameTimeMax(series));
+    }
+    printf("  %d saccades de plus de %.1f ms\n", seaFrameTimeHitches(), CVar::hitchMs);
+}
+
+bool seaFrameTimeWriteCsv(const char* path)
+{
+    if (frameCount == 0)
+        return true;
+
+    printf("Temps des %ld images (ms):              p50      p95      p99      max\n", frameCount);
+    for (int s = 0; s < SeaFrameSeriesCount; s++)
+    {
+        printf("  %-36s %8.2f %8.2f %8.2f %8.2f\n", seriesNames[s], percentileOf(frameRun[s], 50.0),
+               percentileOf(frameRun[s], 95.0), percentileOf(frameRun[s], 99.0), frameRunMax[s]);
+    }
+    printf("  %ld saccades de plus de %.1f ms\n", frameRunHitches, CVar::hitchMs);
+
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+    fprintf(file, "low_ms,high_ms,frame,cpu,gpu\n");
+    for (int b = 0; b < SEA_FRAME_BUCKETS; b++)
+    {
+        if (!frameRun[SeaFrameWall].counts[b] && !frameRun[SeaFrameCpu].counts[b] && !frameRun[SeaFrameGpu].counts[b])
+            continue;
+        double low, high;
+        bucketRange(b, low, high);
+        fprintf(file, "%.3f,%.3f,%u,%u,%u\n", low, high, frameRun[SeaFrameWall].counts[b],
+                frameRun[SeaFrameCpu].counts[b], frameRun[SeaFrameGpu].counts[b]);
+    }
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+// Frame time telemetry: the wall time of every frame, the CPU time of its
+// work (camera and drawScene(), without the swap) and the GPU time of
+// SeaLod.h go into fixed histograms, one for the last SEA_FRAME_WINDOW
+// frames and one for the whole run. Nothing is allocated per frame.
+//
+// Buckets follow HdrHistogram: values in microseconds, exact below
+// SEA_FRAME_SUB_BUCKETS, then SEA_FRAME_SUB_BUCKETS / 2 linear buckets per
+// power of two: a bucket is at most 2 / SEA_FRAME_SUB_BUCKETS (about 6 %)
+// as wide as its values, from 1 us to SEA_FRAME_MAX_US.
+//
+// A frame longer than CVar::hitchMs counts as a hitch.
+
+// power of two
+#define SEA_FRAME_SUB_BUCKETS 32
+#define SEA_FRAME_MAGNITUDES 16
+#define SEA_FRAME_BUCKETS (SEA_FRAME_SUB_BUCKETS + SEA_FRAME_MAGNITUDES * SEA_FRAME_SUB_BUCKETS / 2)
+// longer values land in the last bucket (about 2 s)
+#define SEA_FRAME_MAX_US (SEA_FRAME_SUB_BUCKETS << SEA_FRAME_MAGNITUDES)
+// frames of the rolling window
+#define SEA_FRAME_WINDOW 600
+
+enum SeaFrameSeries
+{
+    SeaFrameWall, // time between two frames
+    SeaFrameCpu,  // CPU work of the frame
+    SeaFrameGpu,  // GPU time (SeaLod.h), a few frames late
+    SeaFrameSeriesCount
+};
+
+/// Records a frame (ms). A negative gpuMs, when no new timer query result came in, is left out.
+void seaFrameTimeAdd(double wallMs, double cpuMs, double gpuMs);
+
+/// Percentile (0 to 100) of the rolling window (ms), upper bound of its bucket.
+double seaFrameTimePercentile(SeaFrameSeries series, double percentile);
+
+/// Longest frame of the rolling window (ms), exact.
+double seaFrameTimeMax(SeaFrameSeries series);
+
+/// Frames of the rolling window, and the hitches among them.
+int seaFrameTimeCount();
+int seaFrameTimeHitches();
+
+/// p50, p95, p99 and max of each series, and the hitches, over the rolling window.
+void seaFrameTimePrint();
+
+/**
+* Whole run histogram to CSV: low_ms, high_ms, then the frame count of each
+* series, one line per bucket that holds a frame. Prints the run summary.
+*/
+bool seaFrameTimeWriteCsv(const char* path);
@@ -0,0 +1,254 @@
+// Gerstner waves: wave set, uniform buffer and CPU evaluation, see SeaGerstner.h.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "SeaGerstner.h"
+#include "SeaMemory.h"
+#include "Var.h"
+
+#define SEA_GERSTNER_GRAVITY 9.81
+#define SEA_GERSTNER_PI 3.14159265358979323846
+
+/// std140 layout of the SeaGerstner block of Nuanceurs/seaGerstner.glsl
+struct SeaGerstnerBlock
+{
+    glm::vec4 dirK[SEA_GERSTNER_MAX_WAVES];     // direction x, direction z, k, wavelength
+    glm::vec4 ampPhase[SEA_GERSTNER_MAX_WAVES]; // amplitude, choppiness * amplitude, phase, 0
+    GLint     count;
+    GLint     padding[3];
+};
+
+static std::vector<SeaGerstnerWave> gerstnerWaves;
+static GLuint                       gerstnerUbo = 0;
+
+std::vector<SeaGerstnerWave> seaGerstnerCalmSea(float windDirection, int count, unsigned seed)
+{
+    std::mt19937                          rng(seed);
+    std::uniform_real_distribution<float> spread(-0.6f, 0.6f);
+    std::uniform_real_distribution<float> phase(0.0f, 2.0f * static_cast<float>(SEA_GERSTNER_PI));
+
+    std::vector<SeaGerstnerWave> waves(count);
+    for (int i = 0; i < count; i++)
+    {
+        float angle = windDirection + spread(rng);
+
+        SeaGerstnerWave& w = waves[i];
+        w.direction        = glm::vec2(std::cos(angle), std::sin(angle));
+        w.wavelength       = 40.0f * std::pow(0.75f, static_cast<float>(i));
+        // k A = 0.04: long, low swell
+        w.amplitude  = 0.04f * w.wavelength / (2.0f * static_cast<float>(SEA_GERSTNER_PI));
+        w.choppiness = 1.0f;
+        w.phase      = phase(rng);
+    }
+    return waves;
+}
+
+void seaGerstnerInit()
+{
+    seaMemGenBuffers(SeaMemBuffers, 1, &gerstnerUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, gerstnerUbo);
+    seaMemBufferData(gerstnerUbo, GL_UNIFORM_BUFFER, sizeof(SeaGerstnerBlock), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    seaGerstnerSetWaves(seaGerstnerCalmSea(0.0f, 16, 1u));
+    seaGerstnerUpdate(0.0f);
+}
+
+void seaGerstnerShutdown()
+{
+    seaMemDeleteBuffers(1, &gerstnerUbo);
+    gerstnerUbo = 0;
+}
+
+void seaGerstnerSetWaves(const std::vector<SeaGerstnerWave>& waves)
+{
+    gerstnerWaves = waves;
+    std::sort(gerstnerWaves.begin(), gerstnerWaves.end(),
+              [](const SeaGerstnerWave& a, const SeaGerstnerWave& b) { return a.wavelength > b.wavelength; });
+    if (gerstnerWaves.size() > SEA_GERSTNER_MAX_WAVES)
+        gerstnerWaves.resize(SEA_GERSTNER_MAX_WAVES);
+
+    // the surface folds over itself once the horizontal motion outruns the wave
+    float steepness = 0.0f;
+    for (size_t i = 0; i < gerstnerWaves.size(); i++)
+    {
+        SeaGerstnerWave& w = gerstnerWaves[i];
+        w.direction        = glm::normalize(w.direction);
+        steepness += 2.0f * static_cast<float>(SEA_GERSTNER_PI) / w.wavelength * w.choppiness * w.amplitude;
+    }
+    if (steepness > 1.0f)
+    {
+        for (size_t i = 0; i < gerstnerWaves.size(); i++)
+            gerstnerWaves[i].choppiness /= steepness;
+    }
+}
+
+const std::vector<SeaGerstnerWave>& seaGerstnerWaves()
+{
+    return gerstnerWaves;
+}
+
+void seaGerstnerPrepare(float t, int maxWaves, SeaGerstnerSoA& soa)
+{
+    soa.count = std::min(std::max(maxWaves, 0), static_cast<int>(gerstnerWaves.size()));
+    for (int i = 0; i < soa.count; i++)
+    {
+        const SeaGerstnerWave& w = gerstnerWaves[i];
+        double                 k = 2.0 * SEA_GERSTNER_PI / w.wavelength;
+
+        // deep water: w^2 = g k. Wrapped here so the shader and the kernels
+        // never see a large angle, however long the application runs.
+        double phase = std::fmod(w.phase - std::sqrt(SEA_GERSTNER_GRAVITY * k) * t, 2.0 * SEA_GERSTNER_PI);
+        if (phase < 0.0)
+            phase += 2.0 * SEA_GERSTNER_PI;
+
+        soa.dirX[i]      = w.direction.x;
+        soa.dirZ[i]      = w.direction.y;
+        soa.k[i]         = static_cast<float>(k);
+        soa.amplitude[i] = w.amplitude;
+        soa.chop[i]      = w.choppiness * w.amplitude;
+        soa.phase[i]     = static_cast<float>(phase);
+    }
+}
+
+glm::vec3 seaGerstnerBounds(int maxWaves)
+{
+    glm::vec3 bounds(0.0f);
+    int       count = std::min(std::max(maxWaves, 0), static_cast<int>(gerstnerWaves.size()));
+    for (int i = 0; i < count; i++)
+    {
+        bounds.x += gerstnerWaves[i].choppiness * gerstnerWaves[i].amplitude;
+        bounds.y -= gerstnerWaves[i].amplitude;
+        bounds.z += gerstnerWaves[i].amplitude;
+    }
+    return bounds;
+}
+
+void seaGerstnerUpdate(float t)
+{
+    SeaGerstnerSoA soa;
+    seaGerstnerPrepare(t, SEA_GERSTNER_MAX_WAVES, soa);
+
+    SeaGerstnerBlock block = {};
+    for (int i = 0; i < soa.count; i++)
+    {
+        block.dirK[i]     = glm::vec4(soa.dirX[i], soa.dirZ[i], soa.k[i], gerstnerWaves[i].wavelength);
+        block.ampPhase[i] = glm::vec4(soa.amplitude[i], soa.chop[i], soa.phase[i], 0.0f);
+    }
+    block.count = soa.count;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, gerstnerUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void seaGerstnerBind(GLuint prog, const glm::mat4& projection, int viewportHeight)
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, SEA_GERSTNER_BINDING, gerstnerUbo);
+
+    // size of a pixel at distance d: base + scale * d. Perspective: the view
+    // is 2 d / P[1][1] high, orthographic: 2 / P[1][1] at any distance.
+    float pixel       = 2.0f / (projection[1][1] * static_cast<float>(std::max(viewportHeight, 1)));
+    bool  perspective = projection[3][3] == 0.0f;
+
+    glUniform1i(glGetUniformLocation(prog, "gerstnerBudget"), CVar::gerstnerWaveBudget);
+    glUniform1f(glGetUniformLocation(prog, "gerstnerPixelBase"), perspective ? 0.0f : pixel);
+    glUniform1f(glGetUniformLocation(prog, "gerstnerPixelScale"), perspective ? pixel : 0.0f);
+}
+
+void seaGerstnerEvaluate(const glm::vec2* points, size_t count, float t, int maxWaves, float* heights,
+                         glm::vec3* normals, SeaNoiseIsa isa)
+{
+    SeaNoiseIsa best = seaNoiseBestIsa();
+    if (isa == SeaNoiseAuto || isa > best)
+        isa = best;
+
+    SeaGerstnerSoA soa;
+    seaGerstnerPrepare(t, maxWaves, soa);
+
+    switch (isa)
+    {
+    case SeaNoiseAVX2:
+        seaGerstnerKernelAVX2(soa, points, count, heights, normals);
+        break;
+    case SeaNoiseSSE4:
+        seaGerstnerKernelSSE4(soa, points, count, heights, normals);
+        break;
+    default:
+        seaGerstnerKernelScalar(soa, points, count, heights, normals);
+        break;
+    }
+}
+
+void seaGerstnerBenchmark(size_t count)
+{
+    std::vector<glm::vec2> points(count);
+    std::vector<float>     heights(count), reference(count);
+    std::vector<glm::vec3> normals(count);
+    for (size_t i = 0; i < count; i++)
+        points[i] = glm::vec2(static_cast<float>(i % 1000) - 500.0f, static_cast<float>(i / 1000 % 1000) - 500.0f);
+
+    if (gerstnerWaves.empty())
+        seaGerstnerSetWaves(seaGerstnerCalmSea(0.0f, 16, 1u));
+    const int   nWaves = static_cast<int>(gerstnerWaves.size());
+    const float t      = 1234.5f;
+
+    printf("seaGerstner: %u points, %d waves, heights + normals, 1 thread\n", static_cast<unsigned>(count), nWaves);
+    printf("%-10s %8s %16s %14s\n", "isa", "waves", "pts/s", "max |dh|");
+
+    seaGerstnerEvaluate(points.data(), count, t, nWaves, reference.data(), NULL, SeaNoiseScalar);
+    for (int i = SeaNoiseScalar; i <= seaNoiseBestIsa(); i++)
+    {
+        SeaNoiseIsa isa = static_cast<SeaNoiseIsa>(i);
+        for (int waves = nWaves; waves >= 4; waves /= 2)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            seaGerstnerEvaluate(points.data(), count, t, waves, heights.data(), normals.data(), isa);
+            auto t1 = std::chrono::steady_clock::now();
+
+            double maxDiff = 0.0;
+            if (waves == nWaves)
+            {
+                for (size_t k = 0; k < count; k++)
+                    maxDiff = std::max(maxDiff, static_cast<double>(std::fabs(heights[k] - reference[k])));
+            }
+            printf("%-10s %8d %16.0f %14g\n", seaNoiseIsaName(isa), waves,
+                   count / std::chrono::duration<double>(t1 - t0).count(), maxDiff);
+        }
+    }
+
+    // the noise model, same points, for comparison
+    auto t0 = std::chrono::steady_clock::now();
+    seaNoiseEvaluate(points.data(), count, t, 2.0f, heights.data(), normals.data());
+    auto t1 = std::chrono::steady_clock::now();
+    printf("%-10s %8s %16.0f\n", "noise", "-", count / std::chrono::duration<double>(t1 - t0).count());
+
+    // how well the fixed-point iteration finds the water under each point
+    SeaGerstnerSoA soa;
+    seaGerstnerPrepare(t, nWaves, soa);
+    double worst = 0.0;
+    for (size_t k = 0; k < count; k += 97)
+    {
+        glm::vec2 q = points[k];
+        for (int step = 0; step < 32; step++)
+        {
+            glm::vec2 d(0.0f);
+            for (int i = 0; i < soa.count; i++)
+            {
+                float c = std::cos(soa.k[i] * (soa.dirX[i] * q.x + soa.dirZ[i] * q.y) + soa.phase[i]);
+                d += soa.chop[i] * glm::vec2(soa.dirX[i], soa.dirZ[i]) * c;
+            }
+            q = points[k] - d;
+        }
+        float h = 0.0f;
+        for (int i = 0; i < soa.count; i++)
+            h += soa.amplitude[i] * std::sin(soa.k[i] * (soa.dirX[i] * q.x + soa.dirZ[i] * q.y) + soa.phase[i]);
+        worst = std::max(worst, static_cast<double>(std::fabs(h - reference[k])));
+    }
+    printf("\nheight error of the %d-step inversion against a converged one: %g m\n", SEA_GERSTNER_INVERSE_STEPS,
+           worst);
+}
@@ -0,0 +1,103 @@
+#pragma once
+// Gerstner (trochoidal) waves: a small sum of directional waves with analytic
+// normals and horizontal displacement, cheaper than four octaves of simplex
+// noise for calm seas. The waves live in a uniform buffer read by
+// Nuanceurs/seaGerstner.glsl when CVar::waveModel is SEA_WAVE_GERSTNER.
+//
+// Waves are kept sorted by decreasing wavelength, so "the first n waves" is
+// both the CVar::gerstnerWaveBudget cut and the per-patch cut of the
+// tessellation control shader, which drops waves shorter than two pixels at
+// the patch's nearest point.
+
+#include <cstddef>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "SeaNoise.h"
+
+// waves in the uniform buffer
+#define SEA_GERSTNER_MAX_WAVES 32
+// uniform buffer binding point of the SeaGerstner block
+#define SEA_GERSTNER_BINDING 1
+// fixed-point steps finding the undisplaced point under a query position
+#define SEA_GERSTNER_INVERSE_STEPS 3
+
+struct SeaGerstnerWave
+{
+    glm::vec2 direction;  // unit vector in the (x, z) plane
+    float     wavelength; // metres
+    float     amplitude;  // metres, half the crest to trough height
+    float     choppiness; // horizontal / vertical amplitude, 0 = sine wave
+    float     phase;      // radians at t = 0
+};
+
+/// Wave parameters as the evaluation kernels want them, for one time t.
+/// Structure of arrays so the kernels broadcast one wave to every lane.
+struct SeaGerstnerSoA
+{
+    int   count;
+    float dirX[SEA_GERSTNER_MAX_WAVES];
+    float dirZ[SEA_GERSTNER_MAX_WAVES];
+    float k[SEA_GERSTNER_MAX_WAVES];         // 2 pi / wavelength
+    float amplitude[SEA_GERSTNER_MAX_WAVES];
+    float chop[SEA_GERSTNER_MAX_WAVES];      // choppiness * amplitude
+    float phase[SEA_GERSTNER_MAX_WAVES];     // phase - w t, wrapped to [0, 2 pi[
+};
+
+/**
+* Calm sea: count waves from 40 m down to about half a metre, within
+* +-35 degrees of windDirection (radians, 0 = +x), gentle steepness.
+*/
+std::vector<SeaGerstnerWave> seaGerstnerCalmSea(float windDirection, int count, unsigned seed);
+
+/// Creates the uniform buffer with seaGerstnerCalmSea(0, 16, 1). Needs a GL context.
+void seaGerstnerInit();
+void seaGerstnerShutdown();
+
+/**
+* Replaces the wave set: at most SEA_GERSTNER_MAX_WAVES are kept, sorted by
+* decreasing wavelength, and the choppiness is scaled down if needed so the
+* crests never loop (sum of k * choppiness * amplitude <= 1).
+*/
+void seaGerstnerSetWaves(const std::vector<SeaGerstnerWave>& waves);
+const std::vector<SeaGerstnerWave>& seaGerstnerWaves();
+
+/// First maxWaves waves at time t (seconds), phases wrapped in double precision.
+void seaGerstnerPrepare(float t, int maxWaves, SeaGerstnerSoA& soa);
+
+/// Displacement range of the first maxWaves waves: (horizontal reach,
+/// lowest height, highest height) in metres.
+glm::vec3 seaGerstnerBounds(int maxWaves);
+
+/// Writes the waves at time t to the uniform buffer.
+void seaGerstnerUpdate(float t);
+
+/**
+* Binds the uniform buffer and sets the gerstner* uniforms of the active
+* program prog: the wave budget and the size of a pixel, from the projection
+* and the viewport height, for the per-patch culling.
+*/
+void seaGerstnerBind(GLuint prog, const glm::mat4& projection, int viewportHeight);
+
+/**
+* Water surface at count world (x, z) points for time t, using the first
+* maxWaves waves. Gerstner waves move the water horizontally, so the point
+* whose displaced position lands on (x, z) is first found by fixed-point
+* iteration. heights receives the displacement above the rest plane,
+* normals (optional, may be NULL) the unit normal.
+*/
+void seaGerstnerEvaluate(const glm::vec2* points, size_t count, float t, int maxWaves, float* heights,
+                         glm::vec3* normals, SeaNoiseIsa isa = SeaNoiseAuto);
+
+/// Throughput of every kernel against the simplex noise, and deviation from the scalar one.
+void seaGerstnerBenchmark(size_t count);
+
+// Kernels, one per instruction set (SeaKernels*.cpp)
+void seaGerstnerKernelScalar(const SeaGerstnerSoA& waves, const glm::vec2* points, size_t count, float* heights,
+                             glm::vec3* normals);
+void seaGerstnerKernelSSE4(const SeaGerstnerSoA& waves, const glm::vec2* points, size_t count, float* heights,
+                           glm::vec3* normals);
+void seaGerstnerKernelAVX2(const SeaGerstnerSoA& waves, const glm::vec2* points, size_t count, float* heights,
+                           glm::vec3* normals);
@@ -0,0 +1,110 @@
+#pragma once
+// SIMD Gerstner wave sums shared by the per instruction set translation
+// units (SeaKernelsScalar.cpp, SeaKernelsSSE4.cpp, SeaKernelsAVX2.cpp), see
+// SeaKernels.h for the lane types V and seaSin().
+//
+// Same formulas as Nuanceurs/seaGerstner.glsl: for each wave,
+// theta = k (d . p) + phase, displacement (chop d cos theta, A sin theta)
+// and the analytic normal of the displaced surface.
+
+#include "SeaGerstner.h"
+#include "SeaKernels.h"
+
+/**
+* Sum of the waves at undisplaced (x, z): displacement (ox, oy, oz) and,
+* when Normals is set, the unnormalised normal (nx, ny, nz).
+*/
+template <bool Normals, class V>
+inline void seaGerstnerSum(const SeaGerstnerSoA& w, V x, V z, V& ox, V& oy, V& oz, V& nx, V& ny, V& nz)
+{
+    const V quarter(1.5707963f);
+    ox = oy = oz = V(0.0f);
+    nx = nz = V(0.0f);
+    ny = V(1.0f);
+
+    for (int i = 0; i < w.count; i++)
+    {
+        const V dx(w.dirX[i]);
+        const V dz(w.dirZ[i]);
+        const V k(w.k[i]);
+
+        V theta = k * (dx * x + dz * z) + V(w.phase[i]);
+        V s     = seaSin(theta);
+        V c     = seaSin(theta + quarter);
+
+        const V chop(w.chop[i]);
+        ox = ox + chop * dx * c;
+        oz = oz + chop * dz * c;
+        oy = oy + V(w.amplitude[i]) * s;
+
+        if (Normals)
+        {
+            const V ka(w.k[i] * w.amplitude[i]);
+            nx = nx - dx * ka * c;
+            nz = nz - dz * ka * c;
+            ny = ny - V(w.k[i] * w.chop[i]) * s;
+        }
+    }
+}
+
+/**
+* Evaluates a batch of world (x, z) points, V::width points at a time.
+* The last partial group repeats its final point in the unused lanes.
+*/
+template <class V>
+inline void seaGerstnerBatch(const SeaGerstnerSoA& waves, const glm::vec2* points, size_t count, float* heights,
+                             glm::vec3* normals)
+{
+    const size_t W = static_cast<size_t>(V::width);
+    alignas(32) float xs[V::width];
+    alignas(32) float zs[V::width];
+    alignas(32) float hs[V::width];
+    alignas(32) float nxs[V::width];
+    alignas(32) float nys[V::width];
+    alignas(32) float nzs[V::width];
+
+    for (size_t i = 0; i < count; i += W)
+    {
+        size_t n = count - i < W ? count - i : W;
+        for (size_t k = 0; k < W; k++)
+        {
+            const glm::vec2& p = points[i + (k < n ? k : n - 1)];
+            xs[k] = p.x;
+            zs[k] = p.y;
+        }
+
+        // q = target - horizontal displacement(q)
+        const V tx = V::load(xs);
+        const V tz = V::load(zs);
+        V       qx = tx, qz = tz;
+        V       ox, oy, oz, nx, ny, nz;
+        for (int step = 0; step < SEA_GERSTNER_INVERSE_STEPS; step++)
+        {
+            seaGerstnerSum<false>(waves, qx, qz, ox, oy, oz, nx, ny, nz);
+            qx = tx - ox;
+            qz = tz - oz;
+        }
+
+        if (normals)
+        {
+            seaGerstnerSum<true>(waves, qx, qz, ox, oy, oz, nx, ny, nz);
+            V len = vsqrt(nx * nx + ny * ny + nz * nz);
+            (nx / len).store(nxs);
+            (ny / len).store(nys);
+            (nz / len).store(nzs);
+            for (size_t k = 0; k < n; k++)
+                normals[i + k] = glm::vec3(nxs[k], nys[k], nzs[k]);
+        }
+        else
+        {
+            seaGerstnerSum<false>(waves, qx, qz, ox, oy, oz, nx, ny, nz);
+        }
+
+        if (heights)
+        {
+            oy.store(hs);
+            for (size_t k = 0; k < n; k++)
+                heights[i + k] = hs[k];
+        }
+    }
+}
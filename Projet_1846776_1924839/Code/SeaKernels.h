@@ -0,0 +1,315 @@
+#pragma once
+// CPU port of the wave model evaluated in Nuanceurs/nuanceurTessEval.glsl
+// (random3 / simplex3d / simplex3d_fractal / height / getNormal).
+//
+// The kernels are written once against a "lane" type V so the scalar, SSE4
+// and AVX2 versions execute exactly the same sequence of IEEE operations and
+// return bit-identical results. Each SeaKernels*.cpp defines its own lane type
+// (compiled with the matching instruction set) and instantiates seaNoiseBatch.
+//
+// A lane type provides: V(float) broadcast, + - * /, vfloor, vmax, vstep
+// (GLSL step(0.0, a)), vsqrt, static V::load(const float*) / V::store(float*)
+// and a static const int width. Its V::UInt companion holds 32 bit unsigned
+// lanes (U(uint32_t) broadcast, + * ^ >>) converted with vint(V) / vfloat(U).
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "SeaNoise.h"
+
+// Constants shared with nuanceurTessEval.glsl, keep them in sync.
+#define SEA_NOISE_F3          0.3333333f
+#define SEA_NOISE_G3          0.1666667f
+#define SEA_WAVE_WORLD_SCALE  500.0f   // worldPos = (M * pos).xz / 500
+#define SEA_WAVE_TIME_SCALE   0.003f   // Time * 0.003
+#define SEA_WAVE_FREQUENCY    20.0f    // params * 20 + 20
+#define SEA_WAVE_OFFSET       20.0f
+#define SEA_WAVE_NORMAL_DELTA 0.1f     // height(pos + 0.1) finite differences
+
+/**
+* sin() with Cody-Waite range reduction to [-pi/2, pi/2] and a degree 11
+* odd polynomial. random3() amplifies the sine by 4096*512, so every kernel
+* must use this same approximation to stay bit-identical.
+*/
+template <class V>
+inline V seaSin(V x)
+{
+    V k = vfloor(x * V(0.318309886f) + V(0.5f));
+    V r = x - k * V(3.140625f);
+    r = r - k * V(9.67502593994140625e-4f);
+    r = r - k * V(1.509957990978376432e-7f);
+    V parity = k - V(2.0f) * vfloor(k * V(0.5f));
+
+    V r2 = r * r;
+    V p = V(-2.5052108e-8f);
+    p = p * r2 + V(2.7557319e-6f);
+    p = p * r2 - V(1.9841270e-4f);
+    p = p * r2 + V(8.3333333e-3f);
+    p = p * r2 - V(1.6666667e-1f);
+    V s = r + r * r2 * p;
+    return s * (V(1.0f) - V(2.0f) * parity);
+}
+
+template <class V>
+inline V seaFract(V v)
+{
+    return v - vfloor(v);
+}
+
+/**
+* random3(): pseudo random gradient for the lattice point c, in [-0.5, 0.5[.
+*/
+template <class V>
+inline void seaRandom3Sin(V cx, V cy, V cz, V& rx, V& ry, V& rz)
+{
+    V j = V(4096.0f) * seaSin(cx * V(17.0f) + cy * V(59.4f) + cz * V(15.0f));
+    rz = seaFract(V(512.0f) * j);
+    j = j * V(0.125f);
+    rx = seaFract(V(512.0f) * j);
+    j = j * V(0.125f);
+    ry = seaFract(V(512.0f) * j);
+    rx = rx - V(0.5f);
+    ry = ry - V(0.5f);
+    rz = rz - V(0.5f);
+}
+
+/**
+* random3() with the PCG3D integer hash (Jarzynski & Olano 2020) of the
+* lattice point. c only holds integers, so the conversion is exact and every
+* step is integer arithmetic: the result does not depend on the float
+* precision of the device, nor degrade with large coordinates.
+* 24 bits per component are kept so the int -> float conversion is exact.
+*/
+template <class V>
+inline void seaRandom3Pcg(V cx, V cy, V cz, V& rx, V& ry, V& rz)
+{
+    typedef typename V::UInt U;
+    const U mul(1664525u);
+    const U inc(1013904223u);
+
+    U x = vint(cx) * mul + inc;
+    U y = vint(cy) * mul + inc;
+    U z = vint(cz) * mul + inc;
+
+    x = x + y * z;
+    y = y + z * x;
+    z = z + x * y;
+    x = x ^ (x >> 16);
+    y = y ^ (y >> 16);
+    z = z ^ (z >> 16);
+    x = x + y * z;
+    y = y + z * x;
+    z = z + x * y;
+
+    const V scale(1.0f / 16777216.0f);
+    rx = vfloat(x >> 8) * scale - V(0.5f);
+    ry = vfloat(y >> 8) * scale - V(0.5f);
+    rz = vfloat(z >> 8) * scale - V(0.5f);
+}
+
+template <bool IntHash, class V>
+inline void seaRandom3(V cx, V cy, V cz, V& rx, V& ry, V& rz)
+{
+    if (IntHash)
+        seaRandom3Pcg(cx, cy, cz, rx, ry, rz);
+    else
+        seaRandom3Sin(cx, cy, cz, rx, ry, rz);
+}
+
+/**
+* simplex3d(): 3d simplex noise, same steps and operation order as the shader.
+*/
+template <bool IntHash, class V>
+inline V seaSimplex3d(V px, V py, V pz)
+{
+    const V F3(SEA_NOISE_F3);
+    const V G3(SEA_NOISE_G3);
+
+    // s = floor(p + dot(p, vec3(F3)))
+    V dp = px * F3 + py * F3 + pz * F3;
+    V sx = vfloor(px + dp);
+    V sy = vfloor(py + dp);
+    V sz = vfloor(pz + dp);
+
+    // x = p - s + dot(s, vec3(G3))
+    V ds = sx * G3 + sy * G3 + sz * G3;
+    V x0 = px - sx + ds;
+    V y0 = py - sy + ds;
+    V z0 = pz - sz + ds;
+
+    // e = step(vec3(0.0), x - x.yzx)
+    V ex = vstep(x0 - y0);
+    V ey = vstep(y0 - z0);
+    V ez = vstep(z0 - x0);
+
+    // i1 = e*(1.0 - e.zxy), i2 = 1.0 - e.zxy*(1.0 - e)
+    const V one(1.0f);
+    V i1x = ex * (one - ez);
+    V i1y = ey * (one - ex);
+    V i1z = ez * (one - ey);
+    V i2x = one - ez * (one - ex);
+    V i2y = one - ex * (one - ey);
+    V i2z = one - ey * (one - ez);
+
+    V x1 = x0 - i1x + G3, y1 = y0 - i1y + G3, z1 = z0 - i1z + G3;
+    const V G3x2 = V(2.0f) * G3;
+    V x2 = x0 - i2x + G3x2, y2 = y0 - i2y + G3x2, z2 = z0 - i2z + G3x2;
+    const V G3x3 = V(3.0f) * G3;
+    V x3 = x0 - one + G3x3, y3 = y0 - one + G3x3, z3 = z0 - one + G3x3;
+
+    // surflet weights, fading from 0.6 at the center to 0.0 at the margin
+    const V zero(0.0f);
+    V w0 = vmax(V(0.6f) - (x0 * x0 + y0 * y0 + z0 * z0), zero);
+    V w1 = vmax(V(0.6f) - (x1 * x1 + y1 * y1 + z1 * z1), zero);
+    V w2 = vmax(V(0.6f) - (x2 * x2 + y2 * y2 + z2 * z2), zero);
+    V w3 = vmax(V(0.6f) - (x3 * x3 + y3 * y3 + z3 * z3), zero);
+
+    // surflet components
+    V rx, ry, rz;
+    seaRandom3<IntHash>(sx, sy, sz, rx, ry, rz);
+    V d0 = rx * x0 + ry * y0 + rz * z0;
+    seaRandom3<IntHash>(sx + i1x, sy + i1y, sz + i1z, rx, ry, rz);
+    V d1 = rx * x1 + ry * y1 + rz * z1;
+    seaRandom3<IntHash>(sx + i2x, sy + i2y, sz + i2z, rx, ry, rz);
+    V d2 = rx * x2 + ry * y2 + rz * z2;
+    seaRandom3<IntHash>(sx + one, sy + one, sz + one, rx, ry, rz);
+    V d3 = rx * x3 + ry * y3 + rz * z3;
+
+    // multiply d by w^4
+    w0 = w0 * w0; w1 = w1 * w1; w2 = w2 * w2; w3 = w3 * w3;
+    w0 = w0 * w0; w1 = w1 * w1; w2 = w2 * w2; w3 = w3 * w3;
+    d0 = d0 * w0; d1 = d1 * w1; d2 = d2 * w2; d3 = d3 * w3;
+
+    const V k52(52.0f);
+    return d0 * k52 + d1 * k52 + d2 * k52 + d3 * k52;
+}
+
+/**
+* v * m for a GLSL column-major mat3 given by its three columns.
+*/
+template <class V>
+inline void seaRotate(V x, V y, V z, const float c[9], V& ox, V& oy, V& oz)
+{
+    ox = x * V(c[0]) + y * V(c[1]) + z * V(c[2]);
+    oy = x * V(c[3]) + y * V(c[4]) + z * V(c[5]);
+    oz = x * V(c[6]) + y * V(c[7]) + z * V(c[8]);
+}
+
+/**
+* simplex3d_fractal(): four octaves, each rotated to hide directional artifacts.
+*/
+template <bool IntHash, class V>
+inline V seaSimplex3dFractal(V mx, V my, V mz)
+{
+    static const float rot1[9] = { -0.37f, 0.36f, 0.85f, -0.14f, -0.93f, 0.34f, 0.92f, 0.01f, 0.4f };
+    static const float rot2[9] = { -0.55f, -0.39f, 0.74f, 0.33f, -0.91f, -0.24f, 0.77f, 0.12f, 0.63f };
+    static const float rot3[9] = { -0.71f, 0.52f, -0.47f, -0.08f, -0.72f, -0.68f, -0.7f, -0.45f, 0.56f };
+
+    V ax, ay, az;
+    seaRotate(mx, my, mz, rot1, ax, ay, az);
+    V n = V(0.5333333f) * seaSimplex3d<IntHash>(ax, ay, az);
+
+    seaRotate(V(2.0f) * mx, V(2.0f) * my, V(2.0f) * mz, rot2, ax, ay, az);
+    n = n + V(0.2666667f) * seaSimplex3d<IntHash>(ax, ay, az);
+
+    seaRotate(V(4.0f) * mx, V(4.0f) * my, V(4.0f) * mz, rot3, ax, ay, az);
+    n = n + V(0.1333333f) * seaSimplex3d<IntHash>(ax, ay, az);
+
+    return n + V(0.0666667f) * seaSimplex3d<IntHash>(V(8.0f) * mx, V(8.0f) * my, V(8.0f) * mz);
+}
+
+/**
+* height(): vertical displacement of the sea plane at model-space (x, z).
+* The shader then applies M (y = -20), callers add it themselves.
+*/
+template <bool IntHash, class V>
+inline V seaHeight(V x, V z, float time, float waveSize)
+{
+    const V freq(SEA_WAVE_FREQUENCY);
+    const V offset(SEA_WAVE_OFFSET);
+    V px = x / V(SEA_WAVE_WORLD_SCALE);
+    V pz = z / V(SEA_WAVE_WORLD_SCALE);
+    V pt = V(time) * V(SEA_WAVE_TIME_SCALE);
+
+    V h = seaSimplex3dFractal<IntHash>(px * freq + offset, pz * freq + offset, pt * freq + offset);
+    h = V(0.5f) + V(0.5f) * h;
+    return h * V(waveSize);
+}
+
+/**
+* height() plus the getNormal() of the evaluation shader: two extra height
+* samples 0.1 units away along +x and +z, normal = normalize(cross(dz, dx)).
+*/
+template <bool IntHash, class V>
+inline void seaHeightNormal(V x, V z, float time, float waveSize, V& h, V& nx, V& ny, V& nz)
+{
+    const V delta(SEA_WAVE_NORMAL_DELTA);
+    h = seaHeight<IntHash>(x, z, time, waveSize);
+    V hx = seaHeight<IntHash>(x + delta, z, time, waveSize);
+    V hz = seaHeight<IntHash>(x, z + delta, time, waveSize);
+
+    // e1 = (0, hz - h, delta), e2 = (delta, hx - h, 0)
+    V dz = hz - h;
+    V dx = hx - h;
+    nx = V(0.0f) - delta * dx;
+    ny = delta * delta;
+    nz = V(0.0f) - dz * delta;
+
+    V len = vsqrt(nx * nx + ny * ny + nz * nz);
+    nx = nx / len;
+    ny = ny / len;
+    nz = nz / len;
+}
+
+/**
+* Evaluates a batch of model-space (x, z) points, V::width points at a time.
+* The last partial group repeats its final point in the unused lanes.
+*/
+template <class V, bool IntHash>
+inline void seaNoiseBatch(const glm::vec2* points, size_t count, float time, float waveSize,
+                          float* heights, glm::vec3* normals)
+{
+    const size_t W = static_cast<size_t>(V::width);
+    alignas(32) float xs[V::width];
+    alignas(32) float zs[V::width];
+    alignas(32) float hs[V::width];
+    alignas(32) float nxs[V::width];
+    alignas(32) float nys[V::width];
+    alignas(32) float nzs[V::width];
+
+    for (size_t i = 0; i < count; i += W)
+    {
+        size_t n = count - i < W ? count - i : W;
+        for (size_t k = 0; k < W; k++)
+        {
+            const glm::vec2& p = points[i + (k < n ? k : n - 1)];
+            xs[k] = p.x;
+            zs[k] = p.y;
+        }
+
+        V x = V::load(xs);
+        V z = V::load(zs);
+        if (normals)
+        {
+            V h, nx, ny, nz;
+            seaHeightNormal<IntHash>(x, z, time, waveSize, h, nx, ny, nz);
+            h.store(hs);
+            nx.store(nxs);
+            ny.store(nys);
+            nz.store(nzs);
+            for (size_t k = 0; k < n; k++)
+                normals[i + k] = glm::vec3(nxs[k], nys[k], nzs[k]);
+        }
+        else
+        {
+            seaHeight<IntHash>(x, z, time, waveSize).store(hs);
+        }
+
+        if (heights)
+        {
+            for (size_t k = 0; k < n; k++)
+                heights[i + k] = hs[k];
+        }
+    }
+}
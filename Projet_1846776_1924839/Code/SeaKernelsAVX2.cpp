@@ -0,0 +1,73 @@
+// AVX2 instantiation of the CPU wave kernels (see SeaKernels.h).
+// Built with -mavx2 (gcc/clang) or /arch:AVX2 (msvc). FMA is deliberately not
+// enabled so the results stay bit-identical to the scalar and SSE4 kernels.
+
+#include <cstdint>
+#include <immintrin.h>
+
+#include "SeaFftKernels.h"
+#include "SeaGerstnerKernels.h"
+#include "SeaKernels.h"
+
+namespace
+{
+struct U8
+{
+    __m256i v;
+
+    U8() {}
+    U8(__m256i a) : v(a) {}
+    U8(uint32_t u) : v(_mm256_set1_epi32(static_cast<int>(u))) {}
+};
+
+inline U8 operator+(U8 a, U8 b) { return U8(_mm256_add_epi32(a.v, b.v)); }
+inline U8 operator*(U8 a, U8 b) { return U8(_mm256_mullo_epi32(a.v, b.v)); }
+inline U8 operator^(U8 a, U8 b) { return U8(_mm256_xor_si256(a.v, b.v)); }
+inline U8 operator>>(U8 a, int n) { return U8(_mm256_srli_epi32(a.v, n)); }
+
+struct F8
+{
+    typedef U8 UInt;
+    static const int width = 8;
+    __m256 v;
+
+    F8() {}
+    F8(__m256 a) : v(a) {}
+    F8(float f) : v(_mm256_set1_ps(f)) {}
+
+    static F8 load(const float* p) { return F8(_mm256_load_ps(p)); }
+    void store(float* p) const { _mm256_store_ps(p, v); }
+};
+
+inline F8 operator+(F8 a, F8 b) { return F8(_mm256_add_ps(a.v, b.v)); }
+inline F8 operator-(F8 a, F8 b) { return F8(_mm256_sub_ps(a.v, b.v)); }
+inline F8 operator*(F8 a, F8 b) { return F8(_mm256_mul_ps(a.v, b.v)); }
+inline F8 operator/(F8 a, F8 b) { return F8(_mm256_div_ps(a.v, b.v)); }
+inline F8 vfloor(F8 a) { return F8(_mm256_floor_ps(a.v)); }
+inline F8 vmax(F8 a, F8 b) { return F8(_mm256_max_ps(a.v, b.v)); }
+inline F8 vstep(F8 a) { return F8(_mm256_and_ps(_mm256_cmp_ps(a.v, _mm256_setzero_ps(), _CMP_GE_OQ), _mm256_set1_ps(1.0f))); }
+inline F8 vsqrt(F8 a) { return F8(_mm256_sqrt_ps(a.v)); }
+inline U8 vint(F8 a) { return U8(_mm256_cvttps_epi32(a.v)); }
+inline F8 vfloat(U8 a) { return F8(_mm256_cvtepi32_ps(a.v)); }
+}
+
+void seaNoiseKernelAVX2(const glm::vec2* points, size_t count, float time, float waveSize,
+                        float* heights, glm::vec3* normals, bool intHash)
+{
+    if (intHash)
+        seaNoiseBatch<F8, true>(points, count, time, waveSize, heights, normals);
+    else
+        seaNoiseBatch<F8, false>(points, count, time, waveSize, heights, normals);
+}
+
+void seaFftKernelAVX2(const SeaFftPlan& plan, float* re, float* im, float* tmpRe, float* tmpIm,
+                      size_t rowStride, size_t b0, size_t b1)
+{
+    seaFftColumns<F8>(plan, re, im, tmpRe, tmpIm, rowStride, b0, b1);
+}
+
+void seaGerstnerKernelAVX2(const SeaGerstnerSoA& waves, const glm::vec2* points, size_t count, float* heights,
+                           glm::vec3* normals)
+{
+    seaGerstnerBatch<F8>(waves, points, count, heights, normals);
+}
@@ -0,0 +1,72 @@
+// SSE4.1 instantiation of the CPU wave kernels (see SeaKernels.h).
+// Built with -msse4.1 (gcc/clang). Only called when the CPU reports SSE4.1.
+
+#include <cstdint>
+#include <smmintrin.h>
+
+#include "SeaFftKernels.h"
+#include "SeaGerstnerKernels.h"
+#include "SeaKernels.h"
+
+namespace
+{
+struct U4
+{
+    __m128i v;
+
+    U4() {}
+    U4(__m128i a) : v(a) {}
+    U4(uint32_t u) : v(_mm_set1_epi32(static_cast<int>(u))) {}
+};
+
+inline U4 operator+(U4 a, U4 b) { return U4(_mm_add_epi32(a.v, b.v)); }
+inline U4 operator*(U4 a, U4 b) { return U4(_mm_mullo_epi32(a.v, b.v)); }
+inline U4 operator^(U4 a, U4 b) { return U4(_mm_xor_si128(a.v, b.v)); }
+inline U4 operator>>(U4 a, int n) { return U4(_mm_srli_epi32(a.v, n)); }
+
+struct F4
+{
+    typedef U4 UInt;
+    static const int width = 4;
+    __m128 v;
+
+    F4() {}
+    F4(__m128 a) : v(a) {}
+    F4(float f) : v(_mm_set1_ps(f)) {}
+
+    static F4 load(const float* p) { return F4(_mm_load_ps(p)); }
+    void store(float* p) const { _mm_store_ps(p, v); }
+};
+
+inline F4 operator+(F4 a, F4 b) { return F4(_mm_add_ps(a.v, b.v)); }
+inline F4 operator-(F4 a, F4 b) { return F4(_mm_sub_ps(a.v, b.v)); }
+inline F4 operator*(F4 a, F4 b) { return F4(_mm_mul_ps(a.v, b.v)); }
+inline F4 operator/(F4 a, F4 b) { return F4(_mm_div_ps(a.v, b.v)); }
+inline F4 vfloor(F4 a) { return F4(_mm_floor_ps(a.v)); }
+inline F4 vmax(F4 a, F4 b) { return F4(_mm_max_ps(a.v, b.v)); }
+inline F4 vstep(F4 a) { return F4(_mm_and_ps(_mm_cmpge_ps(a.v, _mm_setzero_ps()), _mm_set1_ps(1.0f))); }
+inline F4 vsqrt(F4 a) { return F4(_mm_sqrt_ps(a.v)); }
+inline U4 vint(F4 a) { return U4(_mm_cvttps_epi32(a.v)); }
+inline F4 vfloat(U4 a) { return F4(_mm_cvtepi32_ps(a.v)); }
+}
+
+void seaNoiseKernelSSE4(const glm::vec2* points, size_t count, float time, float waveSize,
+                        float* heights, glm::vec3* normals, bool intHash)
+{
+    if (intHash)
+        seaNoiseBatch<F4, true>(points, count, time, waveSize, heights, normals);
+    else
+        seaNoiseBatch<F4, false>(points, count, time, waveSize, heights, normals);
+}
+
+void seaFftKernelSSE4(const SeaFftPlan& plan, float* re, float* im, float* tmpRe, float* tmpIm,
+                      size_t rowStride, size_t b0, size_t b1)
+{
+    seaFftColumns<F4>(plan, re, im, tmpRe, tmpIm, rowStride, b0, b1);
+}
+
+void seaGerstnerKernelSSE4(const SeaGerstnerSoA& waves, const glm::vec2* points, size_t count, float* heights,
+                           glm::vec3* normals)
+{
+    seaGerstnerBatch<F4>(waves, points, count, heights, normals);
+}
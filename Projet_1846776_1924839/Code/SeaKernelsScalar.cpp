@@ -0,0 +1,82 @@
+// Scalar instantiation of the CPU wave kernels (see SeaKernels.h).
+// Reference implementation, always available.
+
+#include <cmath>
+#include <cstdint>
+
+#include "SeaFftKernels.h"
+#include "SeaGerstnerKernels.h"
+#include "SeaKernels.h"
+
+namespace
+{
+struct U1
+{
+    uint32_t v;
+
+    U1() {}
+    U1(uint32_t u) : v(u) {}
+};
+
+inline U1 operator+(U1 a, U1 b) { return U1(a.v + b.v); }
+inline U1 operator*(U1 a, U1 b) { return U1(a.v * b.v); }
+inline U1 operator^(U1 a, U1 b) { return U1(a.v ^ b.v); }
+inline U1 operator>>(U1 a, int n) { return U1(a.v >> n); }
+
+struct F1
+{
+    typedef U1 UInt;
+    static const int width = 1;
+    float v;
+
+    F1() {}
+    F1(float f) : v(f) {}
+
+    static F1 load(const float* p) { return F1(*p); }
+    void store(float* p) const { *p = v; }
+};
+
+inline F1 operator+(F1 a, F1 b) { return F1(a.v + b.v); }
+inline F1 operator-(F1 a, F1 b) { return F1(a.v - b.v); }
+inline F1 operator*(F1 a, F1 b) { return F1(a.v * b.v); }
+inline F1 operator/(F1 a, F1 b) { return F1(a.v / b.v); }
+inline F1 vfloor(F1 a) { return F1(std::floor(a.v)); }
+inline F1 vmax(F1 a, F1 b) { return F1(a.v > b.v ? a.v : b.v); }
+inline F1 vstep(F1 a) { return F1(a.v >= 0.0f ? 1.0f : 0.0f); }
+inline F1 vsqrt(F1 a) { return F1(std::sqrt(a.v)); }
+inline U1 vint(F1 a) { return U1(static_cast<uint32_t>(static_cast<int32_t>(a.v))); }
+inline F1 vfloat(U1 a) { return F1(static_cast<float>(static_cast<int32_t>(a.v))); }
+}
+
+void seaNoiseKernelScalar(const glm::vec2* points, size_t count, float time, float waveSize,
+                          float* heights, glm::vec3* normals, bool intHash)
+{
+    if (intHash)
+        seaNoiseBatch<F1, true>(points, count, time, waveSize, heights, normals);
+    else
+        seaNoiseBatch<F1, false>(points, count, time, waveSize, heights, normals);
+}
+
+void seaNoiseRandom3(const float c[3], float r[3], bool intHash)
+{
+    F1 rx, ry, rz;
+    if (intHash)
+        seaRandom3<true>(F1(c[0]), F1(c[1]), F1(c[2]), rx, ry, rz);
+    else
+        seaRandom3<false>(F1(c[0]), F1(c[1]), F1(c[2]), rx, ry, rz);
+    r[0] = rx.v;
+    r[1] = ry.v;
+    r[2] = rz.v;
+}
+
+void seaFftKernelScalar(const SeaFftPlan& plan, float* re, float* im, float* tmpRe, float* tmpIm,
+                        size_t rowStride, size_t b0, size_t b1)
+{
+    seaFftColumns<F1>(plan, re, im, tmpRe, tmpIm, rowStride, b0, b1);
+}
+
+void seaGerstnerKernelScalar(const SeaGerstnerSoA& waves, const glm::vec2* points, size_t count, float* heights,
+                             glm::vec3* normals)
+{
+    seaGerstnerBatch<F1>(waves, points, count, heights, normals);
+}
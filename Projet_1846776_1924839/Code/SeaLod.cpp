@@ -0,0 +1,202 @@
+// Sea level of detail controller, see SeaLod.h.
+
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "SeaCdlod.h"
+#include "SeaLod.h"
+#include "Var.h"
+
+// weight of the newest GPU time in the smoothed value
+#define SEA_LOD_SMOOTHING 0.1
+
+static GLuint lodQueries[SEA_LOD_QUERIES] = { 0 };
+static long   lodFrame                    = 0;
+static double lodGpuMs                    = 0.0;
+static double lodLastGpuMs                = 0.0;
+static bool   lodLastGpuNew               = false; // not yet returned by seaLodLastGpuMs()
+static int    lodOverFrames               = 0;
+static int    lodUnderFrames              = 0;
+static FILE*  lodLog                      = NULL;
+static float  lodMotion                   = 0.0f;
+
+// CPU frame times (ms) of the logged frames, camera moving / at rest
+static std::vector<double> lodMovingMs;
+static std::vector<double> lodRestingMs;
+
+void seaLodInit()
+{
+    glGenQueries(SEA_LOD_QUERIES, lodQueries);
+    lodFrame       = 0;
+    lodGpuMs       = 0.0;
+    lodLastGpuNew  = false;
+    lodOverFrames  = 0;
+    lodUnderFrames = 0;
+}
+
+/// Mean and 99th percentile of a set of frame times.
+static void printFrameTimes(const char* label, std::vector<double>& ms)
+{
+    if (ms.empty())
+        return;
+    double sum = 0.0;
+    for (size_t i = 0; i < ms.size(); i++)
+        sum += ms[i];
+    size_t p99 = std::min(ms.size() - 1, static_cast<size_t>(std::ceil(0.99 * ms.size())) - 1);
+    std::nth_element(ms.begin(), ms.begin() + p99, ms.end());
+    printf("%-8s %6u images, moyenne %.2f ms, 99e centile %.2f ms\n", label, static_cast<unsigned>(ms.size()),
+           sum / ms.size(), ms[p99]);
+}
+
+void seaLodShutdown()
+{
+    glDeleteQueries(SEA_LOD_QUERIES, lodQueries);
+    if (lodLog)
+    {
+        fclose(lodLog);
+        printFrameTimes("mouvement", lodMovingMs);
+        printFrameTimes("repos", lodRestingMs);
+    }
+    lodLog = NULL;
+}
+
+bool seaLodOpenLog(const char* path)
+{
+    if (lodLog)
+        fclose(lodLog);
+    lodLog = fopen(path, "w");
+    if (!lodLog)
+        return false;
+    fprintf(lodLog, "frame,cpu_ms,gpu_ms,tess_scale,lod_bias,motion\n");
+    return true;
+}
+
+void seaLodBeginFrame()
+{
+    glBeginQuery(GL_TIME_ELAPSED, lodQueries[lodFrame % SEA_LOD_QUERIES]);
+}
+
+/**
+* One controller step on the smoothed GPU time. Multiplicative steps, faster
+* down than up: a dropped frame costs more than a little missing detail.
+*/
+static void control()
+{
+    // neither knob changes the clipmap
+    if (CVar::seaRenderer == SEA_RENDER_CLIPMAP)
+    {
+        lodOverFrames  = 0;
+        lodUnderFrames = 0;
+        return;
+    }
+    bool tessellated = CVar::seaRenderer == SEA_RENDER_TESS;
+
+    double target = CVar::lodTargetMs;
+    if (lodGpuMs > target)
+    {
+        lodOverFrames++;
+        lodUnderFrames = 0;
+    }
+    else if (lodGpuMs < SEA_LOD_BAND_LOW * target)
+    {
+        lodUnderFrames++;
+        lodOverFrames = 0;
+    }
+    else
+    {
+        lodOverFrames  = 0;
+        lodUnderFrames = 0;
+    }
+
+    if (lodOverFrames >= SEA_LOD_HOLD_FRAMES)
+    {
+        if (tessellated && CVar::tessScale > SEA_LOD_SCALE_MIN)
+            CVar::tessScale = std::max(CVar::tessScale * 0.8f, SEA_LOD_SCALE_MIN);
+        else
+            CVar::lodBias = std::max(CVar::lodBias - 0.25f, SEA_LOD_BIAS_MIN);
+        lodOverFrames = 0;
+    }
+    else if (lodUnderFrames >= SEA_LOD_HOLD_FRAMES)
+    {
+        if (tessellated && CVar::tessScale < SEA_LOD_SCALE_MAX)
+            CVar::tessScale = std::min(CVar::tessScale * 1.1f, SEA_LOD_SCALE_MAX);
+        else
+            CVar::lodBias = std::min(CVar::lodBias + 0.25f, SEA_LOD_BIAS_MAX);
+        lodUnderFrames = 0;
+    }
+}
+
+void seaLodEndFrame(double cpuFrameMs)
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    lodFrame++;
+
+    // oldest query in flight, the one reused next frame
+    if (lodFrame >= SEA_LOD_QUERIES)
+    {
+        GLuint query     = lodQueries[lodFrame % SEA_LOD_QUERIES];
+        GLint  available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+            lodLastGpuMs  = static_cast<double>(ns) * 1e-6;
+            lodLastGpuNew = true;
+            lodGpuMs      = lodGpuMs == 0.0 ? lodLastGpuMs
+                                            : lodGpuMs + SEA_LOD_SMOOTHING * (lodLastGpuMs - lodGpuMs);
+            if (CVar::lodAuto)
+                control();
+        }
+    }
+
+    if (lodLog)
+    {
+        fprintf(lodLog, "%ld,%.3f,%.3f,%.3f,%.2f,%.2f\n", lodFrame, cpuFrameMs, lodLastGpuMs, CVar::tessScale,
+                CVar::lodBias, lodMotion);
+        (lodMotion > 0.5f ? lodMovingMs : lodRestingMs).push_back(cpuFrameMs);
+    }
+}
+
+double seaLodGpuMs()
+{
+    return lodGpuMs;
+}
+
+double seaLodLastGpuMs()
+{
+    if (!lodLastGpuNew)
+        return -1.0;
+    lodLastGpuNew = false;
+    return lodLastGpuMs;
+}
+
+void seaLodMotion(float speed, float turnRate, double dt)
+{
+    float target = 0.0f;
+    if (CVar::lodMotion)
+        target = std::min(std::max(speed / SEA_LOD_MOTION_SPEED, turnRate / SEA_LOD_MOTION_TURN), 1.0f);
+
+    float tau = target > lodMotion ? SEA_LOD_MOTION_ATTACK : SEA_LOD_MOTION_RELEASE;
+    lodMotion += (target - lodMotion) * (1.0f - std::exp(-static_cast<float>(dt) / tau));
+}
+
+float seaLodMotionFactor()
+{
+    return lodMotion;
+}
+
+float seaLodTessScale()
+{
+    return CVar::tessScale * (1.0f - (1.0f - SEA_LOD_MOTION_TESS) * lodMotion);
+}
+
+float seaLodBias()
+{
+    // never under the floor that keeps neighbouring leaves one level apart
+    return std::max(CVar::lodBias * (1.0f - (1.0f - SEA_LOD_MOTION_BIAS) * lodMotion), SEA_LOD_BIAS_MIN);
+}
@@ -0,0 +1,94 @@
+#pragma once
+// Sea level of detail controller: measures the GPU time of each frame with
+// timer queries and steers CVar::tessScale (the tessellation density of
+// SeaTess.h) and CVar::lodBias (the quadtree subdivision
+// distance of needsSubdivision()) to hold CVar::lodTargetMs.
+//
+// The tessellation scale moves first. The quadtree bias only moves once
+// the scale sits at one of its limits, or right away with the CDLOD
+// renderer, which has no tessellation. The clipmap renderer uses neither
+// and is left alone. A change needs the smoothed GPU
+// time to stay outside the dead band for SEA_LOD_HOLD_FRAMES frames in a
+// row, so the levels don't oscillate around the target.
+//
+// On top of that, when CVar::lodMotion is on, a fast moving or turning
+// camera lowers both for as long as it moves: motion hides fine detail.
+// The renderers read the lowered values from seaLodTessScale() and
+// seaLodBias(), the controller keeps steering the CVar ones. The bias never
+// goes under SEA_LOD_BIAS_MIN: from the default 2.5, motion only takes it
+// down to that floor, and most of the saving comes from the tessellation.
+
+// timer queries in flight, results are read this many frames late
+#define SEA_LOD_QUERIES 4
+
+// CVar::tessScale default, back when the controller is turned off, and limits
+#define SEA_LOD_SCALE_DEFAULT 1.0f
+#define SEA_LOD_SCALE_MIN 0.25f
+#define SEA_LOD_SCALE_MAX 4.0f
+
+// CVar::lodBias limits: distance / patch diagonal under which a patch is
+// split. 4 stays under the 500 nodes of the quadtree. From sqrt(5) up,
+// neighbouring leaves are at most one level apart: beside a leaf of size 4w,
+// a leaf of size w has a split parent whose centre is at most sqrt(10) w
+// from the large leaf's, which takes bias * (4w - 2w) / sqrt(2) < sqrt(10) w.
+// The seams of SeaTess.h and SeaCdlod.h rely on it.
+#define SEA_LOD_BIAS_DEFAULT 2.5f
+#define SEA_LOD_BIAS_MIN 2.25f
+#define SEA_LOD_BIAS_MAX 4.0f
+
+// dead band: lower the detail above the target, raise it below 80 % of it
+#define SEA_LOD_BAND_LOW 0.8f
+#define SEA_LOD_HOLD_FRAMES 10
+
+// camera speed (m/s) and turn rate (rad/s) at which motion has its full effect
+#define SEA_LOD_MOTION_SPEED 50.0f
+#define SEA_LOD_MOTION_TURN 1.5f
+// fraction of the tessellation scale and of the quadtree bias kept at full
+// motion, the bias clamped to SEA_LOD_BIAS_MIN
+#define SEA_LOD_MOTION_TESS 0.5f
+#define SEA_LOD_MOTION_BIAS 0.6f
+// time constants (s): detail drops quickly, comes back smoothly
+#define SEA_LOD_MOTION_ATTACK 0.1f
+#define SEA_LOD_MOTION_RELEASE 0.75f
+
+/// Creates the timer queries. Needs a GL context.
+void seaLodInit();
+void seaLodShutdown();
+
+/// Starts timing the GPU work of the frame (GL_TIME_ELAPSED).
+void seaLodBeginFrame();
+
+/**
+* Stops timing, reads the oldest finished query and, when CVar::lodAuto is
+* on, updates CVar::tessScale and CVar::lodBias. cpuFrameMs is the frame
+* time measured by the main loop, written to the log with the GPU time.
+*/
+void seaLodEndFrame(double cpuFrameMs);
+
+/// Smoothed GPU time of the sea frame (ms), 0 until the first query returns.
+double seaLodGpuMs();
+
+/// GPU time of the frame whose query finished since the last call (ms), -1
+/// when none did: each result is returned once.
+double seaLodLastGpuMs();
+
+/**
+* Camera motion of the frame: speed in m/s, turn rate of the view direction
+* in rad/s, frame time dt in seconds. Called by refreshCamera().
+*/
+void seaLodMotion(float speed, float turnRate, double dt);
+
+/// Smoothed motion, 0 at rest to 1 at full effect (0 when CVar::lodMotion is off).
+float seaLodMotionFactor();
+
+/// CVar::tessScale and CVar::lodBias lowered by the camera motion, the bias
+/// clamped to SEA_LOD_BIAS_MIN.
+float seaLodTessScale();
+float seaLodBias();
+
+/**
+* Logs every frame to a CSV file: frame, cpu_ms, gpu_ms, tess_scale,
+* lod_bias, motion. At shutdown, prints the mean and 99th percentile frame
+* times with the camera moving and at rest.
+*/
+bool seaLodOpenLog(const char* path);
@@ -0,0 +1,282 @@
+// Per-frame sea displacement and normal clipmap, see SeaMap.h.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "NuanceurProg.h"
+#include "SeaMap.h"
+#include "SeaMemory.h"
+#include "SeaNoise.h"
+#include "Var.h"
+
+#define SEA_MAP_TILES_PER_SIDE (SEA_MAP_SIZE / SEA_MAP_TILE)
+#define SEA_MAP_TILES_PER_LEVEL (SEA_MAP_TILES_PER_SIDE * SEA_MAP_TILES_PER_SIDE)
+
+struct SeaMapSnapshot
+{
+    glm::vec2 origin; // world (x, z) of the first texel corner
+    float     time;   // shader time the snapshot was baked for
+};
+
+struct SeaMapLevel
+{
+    float extent; // metres covered
+    float period; // seconds between snapshots
+
+    SeaMapSnapshot snapshots[SEA_MAP_SNAPSHOTS];
+    int            prev;      // snapshot shown at blend 0
+    int            next;      // snapshot shown at blend 1
+    int            building;  // snapshot being baked ahead of time
+    int            tilesDone; // tiles of "building" already baked
+    bool           primed;    // prev and next hold valid snapshots
+};
+
+static CNuanceurProg progNuanceurCarte("Nuanceurs/seaCarte.glsl", false);
+
+static GLuint      seaMapTex = 0;
+static SeaMapLevel seaMapLevels[SEA_MAP_LEVELS];
+static float       seaMapTime       = 0.0f;
+static GLint       seaMapWaveSize   = -1;
+static int         seaMapTilesCount = 0;
+
+void seaMapInit()
+{
+    progNuanceurCarte.definir("SEA_NOISE_INT_HASH", std::to_string(SEA_NOISE_INT_HASH));
+    progNuanceurCarte.compilerEtLier();
+
+    seaMemGenTextures(SeaMemTextures, 1, &seaMapTex);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, seaMapTex);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA32F, SEA_MAP_SIZE, SEA_MAP_SIZE,
+                   SEA_MAP_LEVELS * SEA_MAP_SNAPSHOTS);
+    seaMemTextureSize(seaMapTex, 16LL * SEA_MAP_SIZE * SEA_MAP_SIZE * SEA_MAP_LEVELS * SEA_MAP_SNAPSHOTS);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    for (int i = 0; i < SEA_MAP_LEVELS; i++)
+    {
+        SeaMapLevel& level = seaMapLevels[i];
+        level.extent       = SEA_MAP_EXTENT * static_cast<float>(1 << i);
+        level.period       = SEA_MAP_PERIOD * static_cast<float>(1 << i);
+        for (int s = 0; s < SEA_MAP_SNAPSHOTS; s++)
+        {
+            level.snapshots[s].origin = glm::vec2(-0.5f * level.extent);
+            level.snapshots[s].time   = 0.0f;
+        }
+        level.prev      = 0;
+        level.next      = 0;
+        level.building  = 0;
+        level.tilesDone = 0;
+        level.primed    = false;
+    }
+}
+
+void seaMapShutdown()
+{
+    seaMemDeleteTextures(1, &seaMapTex);
+    seaMapTex = 0;
+}
+
+/**
+* Centres a snapshot on the camera. The origin is snapped to the level's texel
+* grid so texels stay on fixed world positions and the waves don't swim when
+* the camera moves.
+*/
+static void placeSnapshot(SeaMapLevel& level, int snapshot, const glm::vec3& cam_position, float t)
+{
+    float texel = level.extent / SEA_MAP_SIZE;
+
+    SeaMapSnapshot& s = level.snapshots[snapshot];
+    s.origin.x        = std::floor(cam_position.x / texel) * texel - 0.5f * level.extent;
+    s.origin.y        = std::floor(cam_position.z / texel) * texel - 0.5f * level.extent;
+    s.time            = t;
+}
+
+/**
+* Bakes the size x size texels of a snapshot starting at texel (x, y).
+* The compute program must be active with the map bound as image 0.
+*/
+static void bakeRegion(int level, int snapshot, int x, int y, int size)
+{
+    GLuint                prog = progNuanceurCarte.getProg();
+    const SeaMapSnapshot& s    = seaMapLevels[level].snapshots[snapshot];
+
+    glUniform1f(glGetUniformLocation(prog, "Time"), s.time);
+    glUniform2i(glGetUniformLocation(prog, "seaMapTile"), x, y);
+    glUniform1i(glGetUniformLocation(prog, "seaMapLayer"), level * SEA_MAP_SNAPSHOTS + snapshot);
+    glUniform2fv(glGetUniformLocation(prog, "seaMapOrigin"), 1, &s.origin[0]);
+    glUniform1f(glGetUniformLocation(prog, "seaMapExtent"), seaMapLevels[level].extent);
+
+    glDispatchCompute(size / 8, size / 8, 1);
+
+    seaMapTilesCount += (size / SEA_MAP_TILE) * (size / SEA_MAP_TILE);
+}
+
+static void bakeTile(int level, int snapshot, int tile)
+{
+    int x = (tile % SEA_MAP_TILES_PER_SIDE) * SEA_MAP_TILE;
+    int y = (tile / SEA_MAP_TILES_PER_SIDE) * SEA_MAP_TILE;
+    bakeRegion(level, snapshot, x, y, SEA_MAP_TILE);
+}
+
+/**
+* Time-sliced update. Each level shows prev -> next while "building" is baked
+* for one period after next. The levels swap once time reaches next and
+* building is complete. If the budget is too small, the level holds "next"
+* until it can swap, instead of exceeding the budget.
+*/
+static void updateSliced(const glm::vec3& cam_position, float t, int budget)
+{
+    for (int i = 0; i < SEA_MAP_LEVELS; i++)
+    {
+        SeaMapLevel& level = seaMapLevels[i];
+        if (!level.primed)
+        {
+            // first frame of the mode: both visible snapshots at once
+            level.prev     = 0;
+            level.next     = 1;
+            level.building = 2;
+            placeSnapshot(level, level.prev, cam_position, t);
+            placeSnapshot(level, level.next, cam_position, t + level.period);
+            bakeRegion(i, level.prev, 0, 0, SEA_MAP_SIZE);
+            bakeRegion(i, level.next, 0, 0, SEA_MAP_SIZE);
+
+            placeSnapshot(level, level.building, cam_position, t + 2.0f * level.period);
+            level.tilesDone = 0;
+            level.primed    = true;
+        }
+        else if (t >= level.snapshots[level.next].time && level.tilesDone == SEA_MAP_TILES_PER_LEVEL)
+        {
+            int old        = level.prev;
+            level.prev     = level.next;
+            level.next     = level.building;
+            level.building = old;
+
+            float start = std::max(level.snapshots[level.next].time, t);
+            placeSnapshot(level, level.building, cam_position, start + level.period);
+            level.tilesDone = 0;
+        }
+    }
+
+    // earliest deadline first: the snapshot in progress must be complete when
+    // time reaches "next", which comes sooner for the near (short period) levels
+    while (budget > 0)
+    {
+        int best = -1;
+        for (int i = 0; i < SEA_MAP_LEVELS; i++)
+        {
+            const SeaMapLevel& level = seaMapLevels[i];
+            if (level.tilesDone == SEA_MAP_TILES_PER_LEVEL)
+                continue;
+            if (best < 0 || level.snapshots[level.next].time <
+                                seaMapLevels[best].snapshots[seaMapLevels[best].next].time)
+                best = i;
+        }
+        if (best < 0)
+            break;
+
+        SeaMapLevel& level = seaMapLevels[best];
+        bakeTile(best, level.building, level.tilesDone);
+        level.tilesDone++;
+        budget--;
+    }
+}
+
+void seaMapUpdate(const glm::vec3& cam_position, float t)
+{
+    seaMapTime       = t;
+    seaMapTilesCount = 0;
+    if (!CVar::seaMapOn || CVar::waveModel != SEA_WAVE_NOISE)
+    {
+        // snapshots go stale while the map is unused
+        for (int i = 0; i < SEA_MAP_LEVELS; i++)
+            seaMapLevels[i].primed = false;
+        return;
+    }
+
+    // snapshots baked with another amplitude are stale
+    bool resliced = CVar::seaMapTileBudget <= 0 || CVar::waveSize != seaMapWaveSize;
+    seaMapWaveSize = CVar::waveSize;
+
+    GLuint prog = progNuanceurCarte.getProg();
+    glUseProgram(prog);
+    glUniform1f(glGetUniformLocation(prog, "waveSize"), static_cast<float>(CVar::waveSize));
+    glBindImageTexture(0, seaMapTex, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+
+    for (int i = 0; i < SEA_MAP_LEVELS; i++)
+    {
+        if (resliced)
+            seaMapLevels[i].primed = false;
+    }
+
+    if (CVar::seaMapTileBudget <= 0)
+    {
+        // whole map every frame
+        for (int i = 0; i < SEA_MAP_LEVELS; i++)
+        {
+            SeaMapLevel& level = seaMapLevels[i];
+            level.prev         = 0;
+            level.next         = 0;
+            placeSnapshot(level, 0, cam_position, t);
+            bakeRegion(i, 0, 0, 0, SEA_MAP_SIZE);
+        }
+    }
+    else
+    {
+        updateSliced(cam_position, t, CVar::seaMapTileBudget);
+    }
+
+    // the TES reads the map with texture fetches
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void seaMapBind(GLuint prog, GLint unit)
+{
+    float     extents[SEA_MAP_LEVELS];
+    glm::vec2 prevOrigins[SEA_MAP_LEVELS];
+    glm::vec2 nextOrigins[SEA_MAP_LEVELS];
+    GLint     prevLayers[SEA_MAP_LEVELS];
+    GLint     nextLayers[SEA_MAP_LEVELS];
+    float     blends[SEA_MAP_LEVELS];
+
+    for (int i = 0; i < SEA_MAP_LEVELS; i++)
+    {
+        const SeaMapLevel&    level = seaMapLevels[i];
+        const SeaMapSnapshot& prev  = level.snapshots[level.prev];
+        const SeaMapSnapshot& next  = level.snapshots[level.next];
+
+        extents[i]     = level.extent;
+        prevOrigins[i] = prev.origin;
+        nextOrigins[i] = next.origin;
+        prevLayers[i]  = i * SEA_MAP_SNAPSHOTS + level.prev;
+        nextLayers[i]  = i * SEA_MAP_SNAPSHOTS + level.next;
+        blends[i]      = 1.0f;
+        if (next.time > prev.time)
+            blends[i] = glm::clamp((seaMapTime - prev.time) / (next.time - prev.time), 0.0f, 1.0f);
+    }
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, seaMapTex);
+
+    glUniform1i(glGetUniformLocation(prog, "seaMapOn"), CVar::seaMapOn);
+    glUniform1i(glGetUniformLocation(prog, "seaMap"), unit);
+    glUniform1fv(glGetUniformLocation(prog, "seaMapExtent"), SEA_MAP_LEVELS, extents);
+    glUniform2fv(glGetUniformLocation(prog, "seaMapPrevOrigin"), SEA_MAP_LEVELS, &prevOrigins[0][0]);
+    glUniform2fv(glGetUniformLocation(prog, "seaMapNextOrigin"), SEA_MAP_LEVELS, &nextOrigins[0][0]);
+    glUniform1iv(glGetUniformLocation(prog, "seaMapPrevLayer"), SEA_MAP_LEVELS, prevLayers);
+    glUniform1iv(glGetUniformLocation(prog, "seaMapNextLayer"), SEA_MAP_LEVELS, nextLayers);
+    glUniform1fv(glGetUniformLocation(prog, "seaMapBlend"), SEA_MAP_LEVELS, blends);
+}
+
+GLuint seaMapTexture()
+{
+    return seaMapTex;
+}
+
+int seaMapTilesBaked()
+{
+    return seaMapTilesCount;
+}
@@ -0,0 +1,50 @@
+#pragma once
+// Camera-centred displacement and normal map of the sea, baked by a compute
+// shader (Nuanceurs/seaCarte.glsl) and sampled by nuanceurTessEval.glsl. The
+// noise cost becomes fixed per frame instead of growing with the number of
+// tessellated vertices.
+//
+// The map is a clipmap: level i of a texture array covers
+// SEA_MAP_EXTENT * 2^i metres around the camera at the same resolution.
+//
+// With CVar::seaMapTileBudget == 0 every level is rebaked each frame.
+// Otherwise each level keeps snapshots baked at two times, and the TES
+// interpolates between them. A third snapshot is baked ahead of time,
+// at most seaMapTileBudget tiles per frame, with near levels first.
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// texels per side of each level
+#define SEA_MAP_SIZE 256
+#define SEA_MAP_LEVELS 6
+// metres covered by the finest level (0.25 m per texel)
+#define SEA_MAP_EXTENT 64.0f
+
+// snapshots kept per level when time-sliced: previous, next and in progress
+#define SEA_MAP_SNAPSHOTS 3
+// texels per side of a tile, the unit of the per-frame budget
+#define SEA_MAP_TILE 64
+// seconds between snapshots of the finest level, doubled at each level
+#define SEA_MAP_PERIOD 0.25f
+
+/// Compiles the compute shader and allocates the texture array. Needs a GL 4.3+ context.
+void seaMapInit();
+void seaMapShutdown();
+
+/// Bakes the map around the camera for shader time t (the Time uniform).
+/// Does nothing while CVar::seaMapOn is off or the wave model isn't SEA_WAVE_NOISE.
+void seaMapUpdate(const glm::vec3& cam_position, float t);
+
+/**
+* Binds the map on texture unit "unit" and sets the seaMap* uniforms of the
+* active program prog. Other passes (lighting, foam) can sample it the same way.
+*/
+void seaMapBind(GLuint prog, GLint unit);
+
+/// RGBA32F texture array: .x = wave height, .yzw = world normal.
+/// Layer of snapshot s of level i: i * SEA_MAP_SNAPSHOTS + s.
+GLuint seaMapTexture();
+
+/// Tiles baked by the last seaMapUpdate().
+int seaMapTilesBaked();
@@ -0,0 +1,237 @@
+// Memory registry, see SeaMemory.h.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <unordered_map>
+
+#include "SeaMemory.h"
+
+// kinds of GL names, which are only unique per kind
+enum MemKind
+{
+    MemBuffer,
+    MemVertexArray,
+    MemTexture,
+    MemRenderbuffer
+};
+
+struct MemEntry
+{
+    SeaMemCategory category;
+    long long      bytes;
+};
+
+struct MemCategory
+{
+    long long bytes;
+    long long peak;
+    long      objects;
+    long long churn; // this frame
+    long      ops;
+    long long frameChurn;
+    long      frameOps;
+};
+
+static std::unordered_map<uint64_t, MemEntry> memObjects;
+static std::unordered_map<void*, MemEntry>    memBlocks;
+static MemCategory                            memCategories[SeaMemCategoryCount] = {};
+
+static const char* memNames[SeaMemCategoryCount] = { "tree_vbo", "buffers", "textures", "targets", "tree_nodes" };
+
+static uint64_t keyOf(MemKind kind, GLuint name)
+{
+    return (static_cast<uint64_t>(kind) << 32) | name;
+}
+
+/// An object or block of category gained (or lost, negative) bytes.
+static void account(SeaMemCategory category, long long bytes)
+{
+    MemCategory& c = memCategories[category];
+    c.bytes += bytes;
+    c.peak = std::max(c.peak, c.bytes);
+    c.churn += bytes < 0 ? -bytes : bytes;
+}
+
+static void created(MemKind kind, SeaMemCategory category, GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        if (!names[i])
+            continue;
+        MemEntry entry                    = { category, 0 };
+        memObjects[keyOf(kind, names[i])] = entry;
+        memCategories[category].objects++;
+        memCategories[category].ops++;
+    }
+}
+
+static void deleted(MemKind kind, GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        std::unordered_map<uint64_t, MemEntry>::iterator it = memObjects.find(keyOf(kind, names[i]));
+        if (it == memObjects.end())
+            continue;
+        account(it->second.category, -it->second.bytes);
+        memCategories[it->second.category].objects--;
+        memCategories[it->second.category].ops++;
+        memObjects.erase(it);
+    }
+}
+
+static void resized(MemKind kind, GLuint name, long long bytes)
+{
+    std::unordered_map<uint64_t, MemEntry>::iterator it = memObjects.find(keyOf(kind, name));
+    // same size again, an orphaned buffer: no allocation changed
+    if (it == memObjects.end() || it->second.bytes == bytes)
+        return;
+    // new storage: the old one is released
+    account(it->second.category, -it->second.bytes);
+    account(it->second.category, bytes);
+    it->second.bytes = bytes;
+}
+
+void seaMemGenBuffers(SeaMemCategory category, GLsizei n, GLuint* names)
+{
+    glGenBuffers(n, names);
+    created(MemBuffer, category, n, names);
+}
+
+void seaMemGenVertexArrays(SeaMemCategory category, GLsizei n, GLuint* names)
+{
+    glGenVertexArrays(n, names);
+    created(MemVertexArray, category, n, names);
+}
+
+void seaMemGenTextures(SeaMemCategory category, GLsizei n, GLuint* names)
+{
+    glGenTextures(n, names);
+    created(MemTexture, category, n, names);
+}
+
+void seaMemGenRenderbuffers(SeaMemCategory category, GLsizei n, GLuint* names)
+{
+    glGenRenderbuffers(n, names);
+    created(MemRenderbuffer, category, n, names);
+}
+
+void seaMemDeleteBuffers(GLsizei n, const GLuint* names)
+{
+    deleted(MemBuffer, n, names);
+    glDeleteBuffers(n, names);
+}
+
+void seaMemDeleteVertexArrays(GLsizei n, const GLuint* names)
+{
+    deleted(MemVertexArray, n, names);
+    glDeleteVertexArrays(n, names);
+}
+
+void seaMemDeleteTextures(GLsizei n, const GLuint* names)
+{
+    deleted(MemTexture, n, names);
+    glDeleteTextures(n, names);
+}
+
+void seaMemDeleteRenderbuffers(GLsizei n, const GLuint* names)
+{
+    deleted(MemRenderbuffer, n, names);
+    glDeleteRenderbuffers(n, names);
+}
+
+void seaMemBufferData(GLuint buffer, GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    glBufferData(target, size, data, usage);
+    resized(MemBuffer, buffer, size);
+}
+
+void seaMemTextureSize(GLuint texture, long long bytes)
+{
+    resized(MemTexture, texture, bytes);
+}
+
+void seaMemRenderbufferSize(GLuint renderbuffer, long long bytes)
+{
+    resized(MemRenderbuffer, renderbuffer, bytes);
+}
+
+void* seaMemMalloc(SeaMemCategory category, size_t bytes)
+{
+    void* block = malloc(bytes);
+    if (!block)
+        return NULL;
+    MemEntry entry   = { category, static_cast<long long>(bytes) };
+    memBlocks[block] = entry;
+    memCategories[category].objects++;
+    memCategories[category].ops++;
+    account(category, entry.bytes);
+    return block;
+}
+
+void seaMemFree(void* block)
+{
+    std::unordered_map<void*, MemEntry>::iterator it = memBlocks.find(block);
+    if (it != memBlocks.end())
+    {
+        account(it->second.category, -it->second.bytes);
+        memCategories[it->second.category].objects--;
+        memCategories[it->second.category].ops++;
+        memBlocks.erase(it);
+    }
+    free(block);
+}
+
+void seaMemFrame()
+{
+    for (int c = 0; c < SeaMemCategoryCount; c++)
+    {
+        memCategories[c].frameChurn = memCategories[c].churn;
+        memCategories[c].frameOps   = memCategories[c].ops;
+        memCategories[c].churn      = 0;
+        memCategories[c].ops        = 0;
+    }
+}
+
+SeaMemStats seaMemStats(SeaMemCategory category)
+{
+    const MemCategory& c     = memCategories[category];
+    SeaMemStats        stats = { c.bytes, c.peak, c.objects, c.frameChurn, c.frameOps };
+    return stats;
+}
+
+const char* seaMemName(SeaMemCategory category)
+{
+    return memNames[category];
+}
+
+long long seaMemFrameChurn()
+{
+    long long churn = 0;
+    for (int c = 0; c < SeaMemCategoryCount; c++)
+        churn += memCategories[c].frameChurn;
+    return churn;
+}
+
+void seaMemPrint()
+{
+    printf("Memoire (Ko):     actuelle      pic   objets   creations+destructions/image\n");
+    for (int c = 0; c < SeaMemCategoryCount; c++)
+    {
+        const MemCategory& m = memCategories[c];
+        printf("  %-12s %10.1f %8.1f %8ld   %ld (%.1f Ko)\n", memNames[c], m.bytes / 1024.0, m.peak / 1024.0,
+               m.objects, m.frameOps, m.frameChurn / 1024.0);
+    }
+}
+
+void seaMemWriteJson(FILE* out)
+{
+    fprintf(out, "  \"memory\": {");
+    for (int c = 0; c < SeaMemCategoryCount; c++)
+    {
+        const MemCategory& m = memCategories[c];
+        fprintf(out, "%s\n    \"%s\": { \"bytes\": %lld, \"peak\": %lld, \"objects\": %ld }", c ? "," : "",
+                memNames[c], m.bytes, m.peak, m.objects);
+    }
+    fprintf(out, "\n  }");
+}
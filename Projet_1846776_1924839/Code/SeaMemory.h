@@ -0,0 +1,72 @@
+#pragma once
+// Memory registry: the GL buffers, vertex arrays, textures and renderbuffers
+// of the sea, and the CPU heap of the quadtree, are created and deleted
+// through these functions, which keep their size per category. Current and
+// peak bytes, and the churn (bytes created plus deleted) of the last frame,
+// go to the debug output and to the --benchmark report.
+//
+// Sizes are the storage asked for: glBufferData() sizes, texel counts times
+// bytes per texel (RGB counted as 4 bytes, mipmaps as a third more).
+// Vertex arrays are counted, not sized. Name 0 is not tracked, nor names
+// the registry didn't create. Storage specified again at the same size, as
+// when a streamed buffer is orphaned every frame, is not churn.
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <GL/glew.h>
+
+enum SeaMemCategory
+{
+    SeaMemTreeVbo,   // VAOs and VBOs of the quadtree nodes, createNodeVao()
+    SeaMemBuffers,   // the other GL buffers of the sea
+    SeaMemTextures,  // CTexture2D, wave map, FFT maps, benchmark target
+    SeaMemTargets,   // renderbuffers
+    SeaMemTreeNodes, // CPU: node array of the quadtree
+    SeaMemCategoryCount
+};
+
+struct SeaMemStats
+{
+    long long bytes;      // now
+    long long peak;       // highest bytes so far
+    long      objects;    // GL objects or CPU blocks alive
+    long long frameChurn; // bytes created plus deleted during the last frame
+    long      frameOps;   // creations plus deletions during the last frame
+};
+
+/// Like glGenXxx(), the new objects belong to category.
+void seaMemGenBuffers(SeaMemCategory category, GLsizei n, GLuint* names);
+void seaMemGenVertexArrays(SeaMemCategory category, GLsizei n, GLuint* names);
+void seaMemGenTextures(SeaMemCategory category, GLsizei n, GLuint* names);
+void seaMemGenRenderbuffers(SeaMemCategory category, GLsizei n, GLuint* names);
+
+/// Like glDeleteXxx().
+void seaMemDeleteBuffers(GLsizei n, const GLuint* names);
+void seaMemDeleteVertexArrays(GLsizei n, const GLuint* names);
+void seaMemDeleteTextures(GLsizei n, const GLuint* names);
+void seaMemDeleteRenderbuffers(GLsizei n, const GLuint* names);
+
+/// glBufferData() on target, where buffer is bound. Replaces its previous size.
+void seaMemBufferData(GLuint buffer, GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+/// Size of a texture or renderbuffer, after glTexImage2D(), glTexStorage2D(), glRenderbufferStorage()...
+void seaMemTextureSize(GLuint texture, long long bytes);
+void seaMemRenderbufferSize(GLuint renderbuffer, long long bytes);
+
+/// Like malloc() and free(), for the CPU heap of category.
+void* seaMemMalloc(SeaMemCategory category, size_t bytes);
+void  seaMemFree(void* block);
+
+/// Ends the frame: its churn becomes the frameChurn of seaMemStats().
+void seaMemFrame();
+
+SeaMemStats seaMemStats(SeaMemCategory category);
+/// Short name, also the key of the JSON report
+const char* seaMemName(SeaMemCategory category);
+/// Bytes created plus deleted during the last frame, every category.
+long long seaMemFrameChurn();
+
+/// One line per category on stdout.
+void seaMemPrint();
+/// "memory": { category: { bytes, peak, objects }, ... } without the trailing comma.
+void seaMemWriteJson(FILE* out);
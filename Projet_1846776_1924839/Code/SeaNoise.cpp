@@ -0,0 +1,192 @@
+// CPU evaluation of the sea wave field: instruction set dispatch and benchmark.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "SeaNoise.h"
+
+/**
+* Detects the best instruction set once. AVX2 also requires the OS to save
+* the ymm registers (OSXSAVE + XCR0).
+*/
+static SeaNoiseIsa detectIsa()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse41   = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2)
+        return SeaNoiseAVX2;
+    if (sse41)
+        return SeaNoiseSSE4;
+    return SeaNoiseScalar;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SeaNoiseAVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return SeaNoiseSSE4;
+    return SeaNoiseScalar;
+#else
+    return SeaNoiseScalar;
+#endif
+}
+
+SeaNoiseIsa seaNoiseBestIsa()
+{
+    static const SeaNoiseIsa best = detectIsa();
+    return best;
+}
+
+const char* seaNoiseIsaName(SeaNoiseIsa isa)
+{
+    switch (isa)
+    {
+    case SeaNoiseScalar: return "scalar";
+    case SeaNoiseSSE4:   return "sse4";
+    case SeaNoiseAVX2:   return "avx2";
+    default:             return "auto";
+    }
+}
+
+void seaNoiseEvaluate(const glm::vec2* points, size_t count, float time, float waveSize,
+                      float* heights, glm::vec3* normals, SeaNoiseIsa isa)
+{
+    seaNoiseEvaluateHash(points, count, time, waveSize, heights, normals, SEA_NOISE_INT_HASH != 0, isa);
+}
+
+void seaNoiseEvaluateHash(const glm::vec2* points, size_t count, float time, float waveSize,
+                          float* heights, glm::vec3* normals, bool intHash, SeaNoiseIsa isa)
+{
+    // never run a kernel the CPU cannot execute
+    SeaNoiseIsa best = seaNoiseBestIsa();
+    if (isa == SeaNoiseAuto || isa > best)
+        isa = best;
+
+    switch (isa)
+    {
+    case SeaNoiseAVX2:
+        seaNoiseKernelAVX2(points, count, time, waveSize, heights, normals, intHash);
+        break;
+    case SeaNoiseSSE4:
+        seaNoiseKernelSSE4(points, count, time, waveSize, heights, normals, intHash);
+        break;
+    default:
+        seaNoiseKernelScalar(points, count, time, waveSize, heights, normals, intHash);
+        break;
+    }
+}
+
+/**
+* Fraction of distinct random3() gradients over a 256 x 256 block of lattice
+* points starting at "offset". fract(512 * 4096 * sin()) only keeps a few bits
+* per component in float, and the sin() hash loses more once the dot product
+* can no longer tell neighbouring lattice points apart.
+*/
+static double hashUniqueness(float offset, bool intHash)
+{
+    std::vector<glm::vec3> gradients;
+    gradients.reserve(256 * 256);
+    for (int i = 0; i < 256; i++)
+    {
+        for (int k = 0; k < 256; k++)
+        {
+            float c[3] = { offset + static_cast<float>(i), offset, offset + static_cast<float>(k) };
+            float r[3];
+            seaNoiseRandom3(c, r, intHash);
+            gradients.push_back(glm::vec3(r[0], r[1], r[2]));
+        }
+    }
+
+    std::sort(gradients.begin(), gradients.end(), [](const glm::vec3& a, const glm::vec3& b) {
+        return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+    });
+    size_t unique = std::unique(gradients.begin(), gradients.end()) - gradients.begin();
+    return static_cast<double>(unique) / (256.0 * 256.0);
+}
+
+void seaNoiseBenchmark(size_t count)
+{
+    const float time     = 1234.5f;
+    const float waveSize = 2.0f;
+
+    // points spread over the 1000 x 1000 sea of createTree()
+    std::vector<glm::vec2> points(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        float u = static_cast<float>(i % 1024) / 1024.0f;
+        float v = static_cast<float>((i / 1024) % 1024) / 1024.0f;
+        points[i] = glm::vec2(u * 1000.0f - 500.0f, v * 1000.0f - 500.0f);
+    }
+
+    std::vector<float>     refHeights(count), heights(count);
+    std::vector<glm::vec3> refNormals(count), normals(count);
+
+    printf("seaNoise: %u points, time %.1f, waveSize %.1f, SEA_NOISE_INT_HASH %d\n", static_cast<unsigned>(count),
+           time, waveSize, SEA_NOISE_INT_HASH);
+    printf("%-6s %-8s %16s %16s %14s %14s\n", "hash", "isa", "heights pts/s", "normals pts/s", "max |dh|",
+           "max |dn|");
+
+    for (int hash = 0; hash < 2; hash++)
+    {
+        bool intHash = hash != 0;
+        seaNoiseEvaluateHash(points.data(), count, time, waveSize, refHeights.data(), refNormals.data(), intHash,
+                             SeaNoiseScalar);
+
+        for (int i = SeaNoiseScalar; i <= seaNoiseBestIsa(); i++)
+        {
+            SeaNoiseIsa isa = static_cast<SeaNoiseIsa>(i);
+
+            auto t0 = std::chrono::steady_clock::now();
+            seaNoiseEvaluateHash(points.data(), count, time, waveSize, heights.data(), NULL, intHash, isa);
+            auto t1 = std::chrono::steady_clock::now();
+            seaNoiseEvaluateHash(points.data(), count, time, waveSize, heights.data(), normals.data(), intHash, isa);
+            auto t2 = std::chrono::steady_clock::now();
+
+            double heightSeconds = std::chrono::duration<double>(t1 - t0).count();
+            double normalSeconds = std::chrono::duration<double>(t2 - t1).count();
+
+            float maxDh = 0.0f;
+            float maxDn = 0.0f;
+            for (size_t k = 0; k < count; k++)
+            {
+                maxDh = std::fmax(maxDh, std::fabs(heights[k] - refHeights[k]));
+                maxDn = std::fmax(maxDn, glm::length(normals[k] - refNormals[k]));
+            }
+
+            printf("%-6s %-8s %16.0f %16.0f %14g %14g\n", intHash ? "pcg" : "sin", seaNoiseIsaName(isa),
+                   count / heightSeconds, count / normalSeconds, maxDh, maxDn);
+        }
+    }
+
+    // Long uptimes and far travel push the lattice coordinates up:
+    // Time * 0.003 * 20 reaches 1e4 after ~2 days and 1e5 after ~19 days.
+    printf("\ndistinct gradients over 256x256 lattice points\n");
+    printf("%-12s %10s %10s\n", "offset", "sin", "pcg");
+    const float offsets[] = { 0.0f, 1.0e3f, 1.0e4f, 1.0e5f, 1.0e6f };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++)
+    {
+        printf("%-12g %9.1f%% %9.1f%%\n", offsets[i], 100.0 * hashUniqueness(offsets[i], false),
+               100.0 * hashUniqueness(offsets[i], true));
+    }
+}
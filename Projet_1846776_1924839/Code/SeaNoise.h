@@ -0,0 +1,69 @@
+#pragma once
+// CPU evaluation of the sea wave field drawn by nuanceurTessEval.glsl.
+// Lets the application query the same heights and normals as the GPU.
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+// Lattice hash used by random3(): 0 = the sin() based hash (original look),
+// 1 = PCG integer hash, cheaper on most GPUs, exact at any coordinate and
+// bit-identical between GLSL and C++. main.cpp forwards it to the shader.
+#ifndef SEA_NOISE_INT_HASH
+#define SEA_NOISE_INT_HASH 0
+#endif
+
+// Wave models of the sea (CVar::waveModel), same values in nuanceurTessEval.glsl
+#define SEA_WAVE_NOISE 0    // fractal simplex noise, this file
+#define SEA_WAVE_FFT 1      // spectral ocean, SeaFft.h
+#define SEA_WAVE_GERSTNER 2 // sum of Gerstner waves, SeaGerstner.h
+
+/// Instruction set used by seaNoiseEvaluate
+enum SeaNoiseIsa
+{
+    SeaNoiseScalar,
+    SeaNoiseSSE4,
+    SeaNoiseAVX2,
+    SeaNoiseAuto
+};
+
+/**
+* Evaluates height() of the evaluation shader for count model-space (x, z)
+* points at shader time "time" (the Time uniform, in seconds).
+* heights receives the vertical displacement before the model matrix is
+* applied, normals (optional, may be NULL) the world-space unit normal.
+*/
+void seaNoiseEvaluate(const glm::vec2* points, size_t count, float time, float waveSize,
+                      float* heights, glm::vec3* normals, SeaNoiseIsa isa = SeaNoiseAuto);
+
+/// Best instruction set supported by this CPU
+SeaNoiseIsa seaNoiseBestIsa();
+
+/// Human readable name of an instruction set
+const char* seaNoiseIsaName(SeaNoiseIsa isa);
+
+/**
+* Measures single-threaded throughput (points/s/core) of every supported
+* kernel and its maximum deviation from the scalar reference, for both
+* lattice hashes, then how well each hash holds up at large coordinates.
+* Printed on stdout.
+*/
+void seaNoiseBenchmark(size_t count);
+
+/**
+* Same as seaNoiseEvaluate() with an explicit lattice hash instead of the
+* compile-time SEA_NOISE_INT_HASH (used to compare both backends).
+*/
+void seaNoiseEvaluateHash(const glm::vec2* points, size_t count, float time, float waveSize,
+                          float* heights, glm::vec3* normals, bool intHash, SeaNoiseIsa isa = SeaNoiseAuto);
+
+// Kernels, one per instruction set (SeaKernels*.cpp)
+void seaNoiseKernelScalar(const glm::vec2* points, size_t count, float time, float waveSize,
+                          float* heights, glm::vec3* normals, bool intHash);
+void seaNoiseKernelSSE4(const glm::vec2* points, size_t count, float time, float waveSize,
+                        float* heights, glm::vec3* normals, bool intHash);
+void seaNoiseKernelAVX2(const glm::vec2* points, size_t count, float time, float waveSize,
+                        float* heights, glm::vec3* normals, bool intHash);
+
+/// random3() of a single lattice point c (scalar reference)
+void seaNoiseRandom3(const float c[3], float r[3], bool intHash);
@@ -0,0 +1,188 @@
+// Frame profiler, see SeaProfile.h.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "SeaProfile.h"
+
+// trace threads
+#define SEA_PROFILE_CPU_TID 1
+#define SEA_PROFILE_GPU_TID 2
+
+struct ProfileEvent
+{
+    const char* name;
+    double      begin; // microseconds since seaProfileInit()
+    double      end;
+};
+
+struct ProfileGpuSet
+{
+    GLuint      queries[SEA_PROFILE_GPU_SCOPES][2];
+    const char* names[SEA_PROFILE_GPU_SCOPES];
+    int         count;
+};
+
+static FILE*                     profileTrace      = NULL;
+static long                      profileFrameIndex = 0;
+static double                    profileFrameStart = 0.0;
+static std::vector<ProfileEvent> profileCpu;
+static std::vector<size_t>       profileCpuStack;
+static ProfileGpuSet             profileGpu[SEA_PROFILE_FRAMES];
+static int                       profileGpuStack[SEA_PROFILE_GPU_SCOPES];
+static int                       profileGpuDepth  = 0;
+static GLint64                   profileGpuOrigin = 0;
+
+static std::chrono::steady_clock::time_point profileOrigin = std::chrono::steady_clock::now();
+
+static double nowUs()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - profileOrigin).count();
+}
+
+void seaProfileInit()
+{
+    for (int f = 0; f < SEA_PROFILE_FRAMES; f++)
+    {
+        for (int s = 0; s < SEA_PROFILE_GPU_SCOPES; s++)
+            glGenQueries(2, profileGpu[f].queries[s]);
+        profileGpu[f].count = 0;
+    }
+
+    // GPU timestamps in the CPU clock: both clocks read at the same moment
+    profileOrigin = std::chrono::steady_clock::now();
+    glGetInteger64v(GL_TIMESTAMP, &profileGpuOrigin);
+    profileFrameIndex = 0;
+    profileFrameStart = 0.0;
+}
+
+/// One complete event ("ph": "X") of the trace.
+static void writeEvent(const char* name, int tid, double begin, double end)
+{
+    if (!profileTrace)
+        return;
+    fprintf(profileTrace, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", name,
+            tid, begin, end - begin);
+}
+
+/// Writes and clears the GPU scopes of a finished query set.
+static void readGpuSet(ProfileGpuSet& set)
+{
+    for (int s = 0; s < set.count; s++)
+    {
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(set.queries[s][0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(set.queries[s][1], GL_QUERY_RESULT, &end);
+        writeEvent(set.names[s], SEA_PROFILE_GPU_TID, (static_cast<GLint64>(begin) - profileGpuOrigin) * 1e-3,
+                   (static_cast<GLint64>(end) - profileGpuOrigin) * 1e-3);
+    }
+    set.count = 0;
+}
+
+void seaProfileShutdown()
+{
+    if (profileTrace)
+    {
+        for (long f = profileFrameIndex - SEA_PROFILE_FRAMES + 1; f <= profileFrameIndex; f++)
+        {
+            if (f >= 0)
+                readGpuSet(profileGpu[f % SEA_PROFILE_FRAMES]);
+        }
+        fprintf(profileTrace, "\n]}\n");
+        fclose(profileTrace);
+    }
+    profileTrace = NULL;
+
+    for (int f = 0; f < SEA_PROFILE_FRAMES; f++)
+    {
+        for (int s = 0; s < SEA_PROFILE_GPU_SCOPES; s++)
+            glDeleteQueries(2, profileGpu[f].queries[s]);
+    }
+}
+
+bool seaProfileOpenTrace(const char* path)
+{
+    if (profileTrace)
+        fclose(profileTrace);
+    profileTrace = fopen(path, "w");
+    if (!profileTrace)
+        return false;
+
+    fprintf(profileTrace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    fprintf(profileTrace, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"CPU\"}}",
+            SEA_PROFILE_CPU_TID);
+    fprintf(profileTrace, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"GPU\"}}",
+            SEA_PROFILE_GPU_TID);
+    profileFrameStart = nowUs();
+    return true;
+}
+
+bool seaProfileOn()
+{
+    return profileTrace != NULL;
+}
+
+void seaProfileBegin(const char* name)
+{
+    if (!profileTrace)
+        return;
+    ProfileEvent e = { name, nowUs(), 0.0 };
+    profileCpuStack.push_back(profileCpu.size());
+    profileCpu.push_back(e);
+}
+
+void seaProfileEnd()
+{
+    if (!profileTrace || profileCpuStack.empty())
+        return;
+    profileCpu[profileCpuStack.back()].end = nowUs();
+    profileCpuStack.pop_back();
+}
+
+void seaProfileGpuBegin(const char* name)
+{
+    if (!profileTrace || profileGpuDepth == SEA_PROFILE_GPU_SCOPES)
+        return;
+
+    // over the limit the scope is not measured, its end is skipped
+    ProfileGpuSet& set   = profileGpu[profileFrameIndex % SEA_PROFILE_FRAMES];
+    int            scope = -1;
+    if (set.count < SEA_PROFILE_GPU_SCOPES)
+    {
+        set.names[set.count] = name;
+        glQueryCounter(set.queries[set.count][0], GL_TIMESTAMP);
+        scope = set.count++;
+    }
+    profileGpuStack[profileGpuDepth++] = scope;
+}
+
+void seaProfileGpuEnd()
+{
+    if (!profileTrace || profileGpuDepth == 0)
+        return;
+    int scope = profileGpuStack[--profileGpuDepth];
+    if (scope >= 0)
+        glQueryCounter(profileGpu[profileFrameIndex % SEA_PROFILE_FRAMES].queries[scope][1], GL_TIMESTAMP);
+}
+
+void seaProfileFrame()
+{
+    if (!profileTrace)
+        return;
+
+    double now = nowUs();
+    writeEvent("frame", SEA_PROFILE_CPU_TID, profileFrameStart, now);
+    for (size_t i = 0; i < profileCpu.size(); i++)
+        writeEvent(profileCpu[i].name, SEA_PROFILE_CPU_TID, profileCpu[i].begin, profileCpu[i].end);
+    profileCpu.clear();
+    profileCpuStack.clear();
+    profileGpuDepth   = 0;
+    profileFrameStart = now;
+
+    // the set reused by the next frame was filled SEA_PROFILE_FRAMES - 1 frames ago
+    profileFrameIndex++;
+    readGpuSet(profileGpu[profileFrameIndex % SEA_PROFILE_FRAMES]);
+}
@@ -0,0 +1,45 @@
+#pragma once
+// Frame profiler: nested CPU scopes and GPU scopes, written as a Chrome /
+// Perfetto trace (chrome://tracing, ui.perfetto.dev) with one complete
+// event per scope, so single hitches can be looked at frame by frame.
+//
+// GPU scopes are GL_TIMESTAMP query pairs, which nest and don't disturb the
+// GL_TIME_ELAPSED query SeaLod.h keeps open around the frame. Each frame
+// has its own query set, SEA_PROFILE_FRAMES in all: a set is read when it
+// comes back for reuse, by then the GPU is done with it and nothing waits.
+//
+// Nothing is measured until seaProfileOpenTrace(), every call is then a flag test.
+
+// query sets in flight
+#define SEA_PROFILE_FRAMES 3
+// GPU scopes per frame, the extra ones are not measured
+#define SEA_PROFILE_GPU_SCOPES 16
+
+/// Creates the queries. Needs a GL context.
+void seaProfileInit();
+/// Reads the last queries and closes the trace.
+void seaProfileShutdown();
+
+/// Starts recording into a trace file.
+bool seaProfileOpenTrace(const char* path);
+bool seaProfileOn();
+
+/// CPU scope. name must outlive the frame (a string literal). Every call is
+/// an event of the trace: scopes go around per-frame work, not per patch.
+void seaProfileBegin(const char* name);
+void seaProfileEnd();
+
+/// GPU scope, around GL commands. Same rule for name.
+void seaProfileGpuBegin(const char* name);
+void seaProfileGpuEnd();
+
+/// Ends the frame (after the swap): writes its CPU scopes and the GPU scopes
+/// of the oldest query set, and starts the next one.
+void seaProfileFrame();
+
+/// CPU scope over a C++ block.
+struct SeaProfileScope
+{
+    explicit SeaProfileScope(const char* name) { seaProfileBegin(name); }
+    ~SeaProfileScope() { seaProfileEnd(); }
+};
@@ -0,0 +1,129 @@
+// Wave height queries for gameplay and buoyancy, sharded across a thread pool.
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "SeaGerstner.h"
+#include "SeaNoise.h"
+#include "SeaQuery.h"
+#include "ThreadPool.h"
+#include "Var.h"
+
+// Points per task: large enough to amortise the scheduling, small enough
+// to balance a few thousand hull samples over every core.
+#define SEA_QUERY_GRAIN 256
+
+static CThreadPool* queryPool = NULL;
+
+static glm::mat4 query_M;     // sea model matrix
+static glm::mat4 query_invM;  // world -> model
+static glm::mat3 query_N;     // normal matrix
+
+void seaQueryInit(const glm::mat4& modelMatrix, unsigned nThreads)
+{
+    seaQueryShutdown();
+
+    query_M    = modelMatrix;
+    query_invM = glm::inverse(modelMatrix);
+    query_N    = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+    queryPool  = new CThreadPool(nThreads);
+}
+
+void seaQueryShutdown()
+{
+    delete queryPool;
+    queryPool = NULL;
+}
+
+/**
+* Evaluates one shard: world xz -> model xz, height() in model space, then
+* back to world space through M like the evaluation shader does.
+*/
+static void queryRange(const glm::vec2* points, size_t begin, size_t end, float t, float waveSize,
+                       float* heights, glm::vec3* normals)
+{
+    glm::vec2 local[SEA_QUERY_GRAIN];
+    float     displacement[SEA_QUERY_GRAIN];
+
+    for (size_t i = begin; i < end; i += SEA_QUERY_GRAIN)
+    {
+        size_t n = end - i < SEA_QUERY_GRAIN ? end - i : SEA_QUERY_GRAIN;
+        for (size_t k = 0; k < n; k++)
+        {
+            glm::vec4 p = query_invM * glm::vec4(points[i + k].x, 0.0f, points[i + k].y, 1.0f);
+            local[k]    = glm::vec2(p.x, p.z);
+        }
+
+        if (CVar::waveModel == SEA_WAVE_GERSTNER)
+            seaGerstnerEvaluate(local, n, t, CVar::gerstnerWaveBudget, displacement, normals ? normals + i : NULL);
+        else
+            seaNoiseEvaluate(local, n, t, waveSize, displacement, normals ? normals + i : NULL);
+
+        for (size_t k = 0; k < n; k++)
+        {
+            glm::vec4 p    = query_M * glm::vec4(local[k].x, displacement[k], local[k].y, 1.0f);
+            heights[i + k] = p.y;
+            if (normals)
+                normals[i + k] = glm::normalize(query_N * normals[i + k]);
+        }
+    }
+}
+
+static void query(const glm::vec2* points, size_t count, float t, float* heights, glm::vec3* normals)
+{
+    float waveSize = static_cast<float>(CVar::waveSize);
+
+    if (!queryPool)
+    {
+        queryRange(points, 0, count, t, waveSize, heights, normals);
+        return;
+    }
+
+    queryPool->parallelFor(count, SEA_QUERY_GRAIN, [&](size_t begin, size_t end) {
+        queryRange(points, begin, end, t, waveSize, heights, normals);
+    });
+}
+
+void seaQueryHeights(const glm::vec2* points, size_t count, float t, float* heights)
+{
+    query(points, count, t, heights, NULL);
+}
+
+void seaQueryHeightsNormals(const glm::vec2* points, size_t count, float t, float* heights, glm::vec3* normals)
+{
+    query(points, count, t, heights, normals);
+}
+
+void seaQueryBenchmark(const glm::mat4& modelMatrix, size_t count)
+{
+    std::vector<glm::vec2> points(count);
+    std::vector<float>     heights(count);
+    for (size_t i = 0; i < count; i++)
+        points[i] = glm::vec2(static_cast<float>(i % 1000) - 500.0f, static_cast<float>(i / 1000 % 1000) - 500.0f);
+
+    // 1, 2, 4, ... threads, then every hardware thread
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    std::vector<unsigned> threadCounts;
+    for (unsigned n = 1; n < maxThreads; n *= 2)
+        threadCounts.push_back(n);
+    threadCounts.push_back(maxThreads > 0 ? maxThreads : 1);
+
+    printf("seaQuery: %u points, isa %s\n", static_cast<unsigned>(count), seaNoiseIsaName(seaNoiseBestIsa()));
+    printf("%-8s %16s %10s\n", "threads", "pts/s", "scaling");
+
+    double single = 0.0;
+    for (size_t i = 0; i < threadCounts.size(); i++)
+    {
+        seaQueryInit(modelMatrix, threadCounts[i]);
+        auto t0 = std::chrono::steady_clock::now();
+        seaQueryHeights(points.data(), count, 1234.5f, heights.data());
+        auto t1 = std::chrono::steady_clock::now();
+
+        double rate = count / std::chrono::duration<double>(t1 - t0).count();
+        if (i == 0)
+            single = rate;
+        printf("%-8u %16.0f %9.2fx\n", threadCounts[i], rate, rate / single);
+    }
+    seaQueryShutdown();
+}
@@ -0,0 +1,27 @@
+#pragma once
+// Wave height queries for gameplay and buoyancy: world-space water height and
+// normal at arbitrary (x, z) points, evaluated with the same wave model as
+// nuanceurTessEval.glsl (simplex noise, or Gerstner waves when CVar::waveModel
+// is SEA_WAVE_GERSTNER) and sharded across a thread pool.
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+/// Starts the query workers. modelMatrix is the sea model matrix (getModelMatrixSea()).
+/// nThreads == 0 uses every hardware thread.
+void seaQueryInit(const glm::mat4& modelMatrix, unsigned nThreads = 0);
+void seaQueryShutdown();
+
+/**
+* World-space water height at each world (x, z) point for shader time t
+* (the Time uniform, i.e. CVar::temps), using the current CVar::waveSize.
+*/
+void seaQueryHeights(const glm::vec2* points, size_t count, float t, float* heights);
+
+/// Same as seaQueryHeights() plus the world-space water normal at each point.
+void seaQueryHeightsNormals(const glm::vec2* points, size_t count, float t, float* heights, glm::vec3* normals);
+
+/// Throughput of seaQueryHeights() for 1 to N threads, printed on stdout.
+/// Restarts the query workers, call seaQueryInit() again afterwards if needed.
+void seaQueryBenchmark(const glm::mat4& modelMatrix, size_t count);
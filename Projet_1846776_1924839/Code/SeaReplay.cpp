@@ -0,0 +1,236 @@
+// Input recording and replay, see SeaReplay.h.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "SeaReplay.h"
+#include "Var.h"
+
+struct ReplayEvent
+{
+    int16_t key;
+    int16_t scancode;
+    uint8_t action;
+    uint8_t mods;
+};
+
+struct ReplayFrame
+{
+    double                   time;
+    double                   mouseDx, mouseDy;
+    uint8_t                  keys;
+    float                    tessScale, lodBias;
+    std::vector<ReplayEvent> events;
+};
+
+enum ReplayMode
+{
+    ReplayOff,
+    ReplayRecording,
+    ReplayPlaying
+};
+
+static const int  replayKeys[]   = SEA_REPLAY_KEYS;
+static const int  replayKeyCount = sizeof(replayKeys) / sizeof(replayKeys[0]);
+static const char replayMagic[4] = { 'S', 'E', 'A', 'R' };
+
+static ReplayMode           replayMode        = ReplayOff;
+static FILE*                replayFile        = NULL;
+static std::vector<uint8_t> replayData;
+static size_t               replayCursor      = 0;
+static ReplayFrame          replayFrame;
+static bool                 replayDispatching = false;
+
+template <typename T> static void writeField(const T& value)
+{
+    fwrite(&value, sizeof(T), 1, replayFile);
+}
+
+template <typename T> static bool readField(T& value)
+{
+    if (replayCursor + sizeof(T) > replayData.size())
+        return false;
+    memcpy(&value, &replayData[replayCursor], sizeof(T));
+    replayCursor += sizeof(T);
+    return true;
+}
+
+bool seaReplayRecord(const char* path)
+{
+    seaReplayShutdown();
+    replayFile = fopen(path, "wb");
+    if (!replayFile)
+        return false;
+
+    uint32_t version = SEA_REPLAY_VERSION;
+    fwrite(replayMagic, 1, sizeof(replayMagic), replayFile);
+    writeField(version);
+    replayMode = ReplayRecording;
+    return true;
+}
+
+bool seaReplayOpen(const char* path)
+{
+    seaReplayShutdown();
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    replayData.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    size_t read = replayData.empty() ? 0 : fread(&replayData[0], 1, replayData.size(), file);
+    fclose(file);
+
+    char     magic[4] = {};
+    uint32_t version  = 0;
+    replayCursor      = 0;
+    if (read != replayData.size() || !readField(magic) || memcmp(magic, replayMagic, sizeof(magic)) != 0
+        || !readField(version) || version != SEA_REPLAY_VERSION)
+    {
+        replayData.clear();
+        return false;
+    }
+    replayMode = ReplayPlaying;
+    return true;
+}
+
+void seaReplayShutdown()
+{
+    if (replayFile)
+        fclose(replayFile);
+    replayFile = NULL;
+    replayData.clear();
+    replayCursor = 0;
+    replayMode   = ReplayOff;
+}
+
+/// Next frame of the recording, false at its end.
+static bool readFrame(ReplayFrame& frame)
+{
+    uint32_t eventCount = 0;
+    if (!readField(frame.time) || !readField(frame.mouseDx) || !readField(frame.mouseDy) || !readField(frame.keys)
+        || !readField(frame.tessScale) || !readField(frame.lodBias) || !readField(eventCount))
+        return false;
+    frame.events.clear();
+    for (uint32_t e = 0; e < eventCount; e++)
+    {
+        ReplayEvent event;
+        if (!readField(event.key) || !readField(event.scancode) || !readField(event.action) || !readField(event.mods))
+            return false;
+        frame.events.push_back(event);
+    }
+    return true;
+}
+
+bool seaReplayBeginFrame()
+{
+    if (replayMode == ReplayRecording)
+    {
+        replayFrame.time      = 0.0;
+        replayFrame.mouseDx   = 0.0;
+        replayFrame.mouseDy   = 0.0;
+        replayFrame.keys      = 0;
+        replayFrame.tessScale = CVar::tessScale;
+        replayFrame.lodBias   = CVar::lodBias;
+        replayFrame.events.clear();
+    }
+    else if (replayMode == ReplayPlaying)
+    {
+        if (!readFrame(replayFrame))
+            return false;
+        CVar::tessScale = replayFrame.tessScale;
+        CVar::lodBias   = replayFrame.lodBias;
+    }
+    return true;
+}
+
+double seaReplayTime(double live)
+{
+    if (replayMode == ReplayRecording)
+        replayFrame.time = live;
+    else if (replayMode == ReplayPlaying)
+        return replayFrame.time;
+    return live;
+}
+
+void seaReplayMouse(double& dx, double& dy)
+{
+    if (replayMode == ReplayRecording)
+    {
+        replayFrame.mouseDx = dx;
+        replayFrame.mouseDy = dy;
+    }
+    else if (replayMode == ReplayPlaying)
+    {
+        dx = replayFrame.mouseDx;
+        dy = replayFrame.mouseDy;
+    }
+}
+
+int seaReplayKey(int key, int liveState)
+{
+    for (int k = 0; k < replayKeyCount; k++)
+    {
+        if (replayKeys[k] != key)
+            continue;
+        if (replayMode == ReplayRecording && liveState == GLFW_PRESS)
+            replayFrame.keys |= 1 << k;
+        else if (replayMode == ReplayPlaying)
+            return (replayFrame.keys & (1 << k)) ? GLFW_PRESS : GLFW_RELEASE;
+    }
+    return liveState;
+}
+
+bool seaReplayKeyEvent(int key, int scancode, int action, int mods)
+{
+    if (replayMode == ReplayPlaying)
+        return replayDispatching;
+
+    if (replayMode == ReplayRecording)
+    {
+        ReplayEvent event;
+        event.key      = static_cast<int16_t>(key);
+        event.scancode = static_cast<int16_t>(scancode);
+        event.action   = static_cast<uint8_t>(action);
+        event.mods     = static_cast<uint8_t>(mods);
+        replayFrame.events.push_back(event);
+    }
+    return true;
+}
+
+void seaReplayEndFrame(GLFWwindow* fenetre, GLFWkeyfun callback)
+{
+    if (replayMode == ReplayRecording)
+    {
+        writeField(replayFrame.time);
+        writeField(replayFrame.mouseDx);
+        writeField(replayFrame.mouseDy);
+        writeField(replayFrame.keys);
+        writeField(replayFrame.tessScale);
+        writeField(replayFrame.lodBias);
+        writeField(static_cast<uint32_t>(replayFrame.events.size()));
+        for (size_t e = 0; e < replayFrame.events.size(); e++)
+        {
+            const ReplayEvent& event = replayFrame.events[e];
+            writeField(event.key);
+            writeField(event.scancode);
+            writeField(event.action);
+            writeField(event.mods);
+        }
+    }
+    else if (replayMode == ReplayPlaying)
+    {
+        replayDispatching = true;
+        for (size_t e = 0; e < replayFrame.events.size(); e++)
+        {
+            const ReplayEvent& event = replayFrame.events[e];
+            callback(fenetre, event.key, event.scancode, event.action, event.mods);
+        }
+        replayDispatching = false;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+// Input recording and replay (--record, --replay): everything a session
+// takes from the outside world, frame by frame, in a small binary file.
+// Replayed, the same file gives the same frames, for profiling a session
+// reported from the field.
+//
+// A frame holds the glfwGetTime() of the main loop, the mouse offsets of
+// pollMouse(), the SEA_REPLAY_KEYS polled by refreshCamera(), the
+// keyboard() events of glfwPollEvents() and CVar::tessScale / CVar::lodBias,
+// which the SeaLod.h controller steers from GPU timings.
+//
+// The input sites pass their live value through a filter: recording stores
+// it, replay swaps in the recorded one, otherwise it is returned as is.
+//
+// File: "SEAR", uint32 version, then per frame: double time, double mouse
+// dx, dy, uint8 key mask, float tessScale, lodBias, uint32 event count and
+// per event int16 key, int16 scancode, uint8 action, uint8 mods. Native
+// byte order. Every event of a frame is kept, however many there are.
+
+#include <GLFW/glfw3.h>
+
+#define SEA_REPLAY_VERSION 2
+// keys of the key mask, polled every frame
+#define SEA_REPLAY_KEYS { GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D }
+
+/// Starts recording into path.
+bool seaReplayRecord(const char* path);
+/// Loads a recording to replay.
+bool seaReplayOpen(const char* path);
+/// Closes the recording.
+void seaReplayShutdown();
+
+/**
+* Start of a main loop frame: with replay, reads the next frame and puts
+* back CVar::tessScale and CVar::lodBias. False once the recording is over.
+*/
+bool seaReplayBeginFrame();
+
+/// Input filters, see above.
+double seaReplayTime(double live);
+void   seaReplayMouse(double& dx, double& dy);
+int    seaReplayKey(int key, int liveState);
+
+/**
+* Called first by keyboard(): records the event, or while replaying, tells
+* whether to handle it: only the recorded events are.
+*/
+bool seaReplayKeyEvent(int key, int scancode, int action, int mods);
+
+/// End of the frame, after glfwPollEvents(): writes the frame, or replays its events through callback.
+void seaReplayEndFrame(GLFWwindow* fenetre, GLFWkeyfun callback);
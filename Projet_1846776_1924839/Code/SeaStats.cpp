@@ -0,0 +1,130 @@
+// Pipeline statistics of the sea draw, see SeaStats.h.
+
+#include <stdio.h>
+
+#include "SeaStats.h"
+
+static const GLenum statTargets[SeaStatCount] = {
+    GL_PRIMITIVES_SUBMITTED_ARB,     GL_TESS_CONTROL_SHADER_PATCHES_ARB, GL_TESS_EVALUATION_SHADER_INVOCATIONS_ARB,
+    GL_PRIMITIVES_GENERATED,         GL_CLIPPING_INPUT_PRIMITIVES_ARB,   GL_CLIPPING_OUTPUT_PRIMITIVES_ARB,
+    GL_FRAGMENT_SHADER_INVOCATIONS_ARB,
+};
+
+static const char* statNames[SeaStatCount] = {
+    "patches_submitted", "tcs_patches", "tes_invocations", "primitives", "clipping_in", "clipping_out", "fragments",
+};
+
+static GLuint        statQueries[SEA_STATS_FRAMES][SeaStatCount] = { { 0 } };
+static bool          statPipeline                                = false;
+static long          statFrame                                   = 0;
+static SeaStatsFrame statLast                                    = { -1, { 0 } };
+static FILE*         statLog                                     = NULL;
+
+bool seaStatSupported(SeaStat stat)
+{
+    return stat == SeaStatPrimitives || statPipeline;
+}
+
+const char* seaStatName(SeaStat stat)
+{
+    return statNames[stat];
+}
+
+void seaStatsInit()
+{
+    statPipeline   = GLEW_ARB_pipeline_statistics_query != GL_FALSE;
+    statFrame      = 0;
+    statLast.frame = -1;
+    for (int i = 0; i < SEA_STATS_FRAMES; i++)
+        glGenQueries(SeaStatCount, statQueries[i]);
+}
+
+void seaStatsShutdown()
+{
+    for (int i = 0; i < SEA_STATS_FRAMES; i++)
+        glDeleteQueries(SeaStatCount, statQueries[i]);
+    if (statLog)
+        fclose(statLog);
+    statLog = NULL;
+}
+
+bool seaStatsOpenLog(const char* path)
+{
+    if (statLog)
+        fclose(statLog);
+    statLog = fopen(path, "w");
+    if (!statLog)
+        return false;
+    fprintf(statLog, "frame");
+    for (int s = 0; s < SeaStatCount; s++)
+        fprintf(statLog, ",%s", statNames[s]);
+    fprintf(statLog, "\n");
+    return true;
+}
+
+void seaStatsBegin()
+{
+    GLuint* queries = statQueries[statFrame % SEA_STATS_FRAMES];
+    for (int s = 0; s < SeaStatCount; s++)
+    {
+        if (seaStatSupported(static_cast<SeaStat>(s)))
+            glBeginQuery(statTargets[s], queries[s]);
+    }
+}
+
+void seaStatsEnd()
+{
+    for (int s = 0; s < SeaStatCount; s++)
+    {
+        if (seaStatSupported(static_cast<SeaStat>(s)))
+            glEndQuery(statTargets[s]);
+    }
+    statFrame++;
+
+    // oldest set in flight, the one reused next frame
+    if (statFrame < SEA_STATS_FRAMES)
+        return;
+    GLuint* queries   = statQueries[statFrame % SEA_STATS_FRAMES];
+    GLint   available = 0;
+    glGetQueryObjectiv(queries[SeaStatPrimitives], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return;
+
+    statLast.frame = statFrame - SEA_STATS_FRAMES;
+    for (int s = 0; s < SeaStatCount; s++)
+    {
+        statLast.values[s] = 0;
+        if (seaStatSupported(static_cast<SeaStat>(s)))
+            glGetQueryObjectui64v(queries[s], GL_QUERY_RESULT, &statLast.values[s]);
+    }
+
+    if (statLog)
+    {
+        fprintf(statLog, "%ld", statLast.frame);
+        for (int s = 0; s < SeaStatCount; s++)
+        {
+            if (seaStatSupported(static_cast<SeaStat>(s)))
+                fprintf(statLog, ",%llu", static_cast<unsigned long long>(statLast.values[s]));
+            else
+                fprintf(statLog, ",");
+        }
+        fprintf(statLog, "\n");
+    }
+}
+
+const SeaStatsFrame& seaStatsLast()
+{
+    return statLast;
+}
+
+void seaStatsPrint()
+{
+    if (statLast.frame < 0)
+        return;
+    printf("Statistiques de la mer (image %ld):\n", statLast.frame);
+    for (int s = 0; s < SeaStatCount; s++)
+    {
+        if (seaStatSupported(static_cast<SeaStat>(s)))
+            printf("  %-18s %llu\n", statNames[s], static_cast<unsigned long long>(statLast.values[s]));
+    }
+}
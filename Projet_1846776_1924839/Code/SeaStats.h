@@ -0,0 +1,53 @@
+#pragma once
+// Pipeline statistics of the sea draw: patches submitted, tessellation
+// control and evaluation work, primitives before and after clipping and
+// fragment shader invocations, from GL_ARB_pipeline_statistics_query and a
+// GL_PRIMITIVES_GENERATED query around renderSea().
+//
+// Queries are read SEA_STATS_FRAMES - 1 frames late, so the CPU never waits
+// on the GPU. Without the extension only the primitive count is measured.
+
+#include <GL/glew.h>
+
+// query sets in flight
+#define SEA_STATS_FRAMES 3
+
+enum SeaStat
+{
+    SeaStatPatches,        // GL_PRIMITIVES_SUBMITTED_ARB: patches sent by the draws
+    SeaStatTcsPatches,     // GL_TESS_CONTROL_SHADER_PATCHES_ARB
+    SeaStatTesInvocations, // GL_TESS_EVALUATION_SHADER_INVOCATIONS_ARB
+    SeaStatPrimitives,     // GL_PRIMITIVES_GENERATED
+    SeaStatClipIn,         // GL_CLIPPING_INPUT_PRIMITIVES_ARB
+    SeaStatClipOut,        // GL_CLIPPING_OUTPUT_PRIMITIVES_ARB
+    SeaStatFragments,      // GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+    SeaStatCount
+};
+
+struct SeaStatsFrame
+{
+    long     frame; // frame the values belong to, -1 before the first result
+    GLuint64 values[SeaStatCount];
+};
+
+/// Creates the queries. Needs a GL context.
+void seaStatsInit();
+void seaStatsShutdown();
+
+/// Is the statistic measured on this GL implementation?
+bool seaStatSupported(SeaStat stat);
+/// Short name, also the CSV column
+const char* seaStatName(SeaStat stat);
+
+/// Start and stop counting, around the sea draw. Once per frame.
+void seaStatsBegin();
+void seaStatsEnd();
+
+/// Newest finished frame.
+const SeaStatsFrame& seaStatsLast();
+
+/// Writes seaStatsLast() to stdout, one statistic per line.
+void seaStatsPrint();
+
+/// Logs every finished frame to a CSV file: frame, then one column per statistic.
+bool seaStatsOpenLog(const char* path);
@@ -0,0 +1,93 @@
+// Tessellation levels of the sea patches, see SeaTess.h.
+
+#include <algorithm>
+#include <cmath>
+
+#include <GL/glew.h>
+
+#include "SeaLod.h"
+#include "SeaMemory.h"
+#include "SeaTess.h"
+#include "Var.h"
+
+static GLuint tessBuffer = 0;
+
+SeaTessView seaTessCurrentView(const glm::mat4& model)
+{
+    SeaTessView view;
+    view.modelView         = CVar::vue * model;
+    view.projection        = CVar::projection;
+    view.viewport          = glm::vec2(static_cast<float>(CVar::currentW), static_cast<float>(CVar::currentH));
+    view.pixelsPerTriangle = CVar::pixelsPerTriangle;
+    view.tessScale         = seaLodTessScale();
+
+    // gaze point (normalised device coordinates) to a view space direction
+    view.foveation  = CVar::foveation && view.projection[3][3] == 0.0f;
+    view.gaze       = glm::normalize(glm::vec3(CVar::foveaGaze.x / view.projection[0][0],
+                                               CVar::foveaGaze.y / view.projection[1][1], -1.0f));
+    view.foveaInner = glm::radians(CVar::foveaRadius);
+    view.foveaOuter = glm::radians(CVar::foveaRadius + std::max(CVar::foveaFalloff, 0.1f));
+    return view;
+}
+
+float seaTessFoveation(const SeaTessView& view, const glm::vec3& centre, float radius)
+{
+    if (!view.foveation)
+        return 1.0f;
+
+    glm::vec3 p = glm::vec3(view.modelView * glm::vec4(centre, 1.0f));
+    float     d = glm::length(p);
+    if (d <= radius)
+        return 1.0f;
+
+    float angle = std::acos(std::min(std::max(glm::dot(p / d, view.gaze), -1.0f), 1.0f)) - std::asin(radius / d);
+    float t     = std::min(std::max((angle - view.foveaInner) / (view.foveaOuter - view.foveaInner), 0.0f), 1.0f);
+    t           = t * t * (3.0f - 2.0f * t);
+    return 1.0f - (1.0f - SEA_TESS_FOVEA_MIN) * t;
+}
+
+float seaTessEdgeLevel(const SeaTessView& view, glm::vec3 a, glm::vec3 b)
+{
+    // same operands in the same order whichever patch asks
+    if (b.x < a.x || (b.x == a.x && b.z < a.z))
+        std::swap(a, b);
+
+    // pixels covered on screen by a sphere whose diameter is the edge
+    glm::vec3 mid = 0.5f * (a + b);
+    float     d   = 1.0f;
+    if (view.projection[3][3] == 0.0f)
+        d = std::max(glm::length(glm::vec3(view.modelView * glm::vec4(mid, 1.0f))), 0.1f);
+    float pixels = glm::distance(a, b) * 0.5f * view.viewport.y * view.projection[1][1] / d;
+
+    float fovea    = seaTessFoveation(view, mid, 0.5f * glm::distance(a, b));
+    float segments = std::max(pixels * view.tessScale * fovea / view.pixelsPerTriangle, 1.0f);
+    return std::min(std::max(std::exp2(std::ceil(std::log2(segments))), SEA_TESS_MIN_LEVEL), SEA_TESS_MAX_LEVEL);
+}
+
+void seaTessInit()
+{
+    seaMemGenBuffers(SeaMemBuffers, 1, &tessBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, tessBuffer);
+    seaMemBufferData(tessBuffer, GL_SHADER_STORAGE_BUFFER, SEA_TESS_MAX_PATCHES * sizeof(SeaTessPatch), NULL,
+                     GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void seaTessShutdown()
+{
+    seaMemDeleteBuffers(1, &tessBuffer);
+    tessBuffer = 0;
+}
+
+void seaTessUpload(const SeaTessPatch* patches, int count)
+{
+    count = std::min(std::max(count, 0), SEA_TESS_MAX_PATCHES);
+
+    // orphan last frame's storage, the GPU may still be reading it
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, tessBuffer);
+    seaMemBufferData(tessBuffer, GL_SHADER_STORAGE_BUFFER, SEA_TESS_MAX_PATCHES * sizeof(SeaTessPatch), NULL,
+                     GL_STREAM_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(SeaTessPatch), patches);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SEA_TESS_BINDING, tessBuffer);
+}
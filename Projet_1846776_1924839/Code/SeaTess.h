@@ -0,0 +1,78 @@
+#pragma once
+// Tessellation levels of the sea patches, computed on the CPU once per frame
+// and read by nuanceurTessCtrl.glsl from a shader storage buffer indexed by
+// the patchIndex uniform.
+//
+// An edge is split into the smallest power of two of segments no longer than
+// CVar::pixelsPerTriangle pixels (times CVar::tessScale). The level of an
+// edge only depends on its end points, taken in a fixed order, so the two
+// patches sharing it compute the same value. An edge along a larger
+// neighbour takes half the neighbour's level: powers of two keep its
+// vertices on the neighbour's ones, without cracks. That needs neighbours
+// at most one level apart, which the quadtree keeps with a bias of at least
+// SEA_LOD_BIAS_MIN, and a SEA_TESS_MIN_LEVEL of 4, whose half is still an
+// even level: fractional_even_spacing would round 1 up to 2.
+//
+// With CVar::foveation, edges away from the gaze point (CVar::foveaGaze,
+// the screen centre by default) get fewer segments: full detail within
+// CVar::foveaRadius degrees of it, down to SEA_TESS_FOVEA_MIN after another
+// CVar::foveaFalloff degrees. The quadtree doesn't use it: a lower split
+// distance in the periphery would break the one level between neighbours.
+
+#include <glm/glm.hpp>
+
+// shader storage buffer binding point, injected in the TCS as SEA_TESS_BINDING
+#define SEA_TESS_BINDING 0
+// patches in the buffer, MAX_SURFACE_NODES of SurfaceNode.cpp
+#define SEA_TESS_MAX_PATCHES 500
+
+// 4 or more, the seams take half of it
+#define SEA_TESS_MIN_LEVEL 4.0f
+#define SEA_TESS_MAX_LEVEL 64.0f
+
+// detail kept far from the gaze point
+#define SEA_TESS_FOVEA_MIN 0.25f
+
+/// std430 layout of one entry of the SeaTessLevels buffer
+struct SeaTessPatch
+{
+    float outer[4]; // gl_TessLevelOuter, quad domain order
+    float inner[2]; // gl_TessLevelInner
+    float padding[2];
+};
+
+/// What the level of an edge depends on besides its end points
+struct SeaTessView
+{
+    glm::mat4 modelView;
+    glm::mat4 projection;
+    glm::vec2 viewport;      // pixels
+    float     pixelsPerTriangle;
+    float     tessScale;
+
+    bool      foveation;   // perspective projection and CVar::foveation
+    glm::vec3 gaze;        // unit gaze direction, view space
+    float     foveaInner;  // radians of full detail around the gaze
+    float     foveaOuter;  // radians where the detail reaches SEA_TESS_FOVEA_MIN
+};
+
+/// Current camera, window and CVar settings for a model matrix.
+SeaTessView seaTessCurrentView(const glm::mat4& model);
+
+/**
+* Detail factor, SEA_TESS_FOVEA_MIN to 1, of the model space sphere
+* (centre, radius) from its angular distance to the gaze direction,
+* measured to the nearest point of the sphere. 1 without foveation.
+*/
+float seaTessFoveation(const SeaTessView& view, const glm::vec3& centre, float radius);
+
+/// Level of the model space edge ab: a power of two in
+/// [SEA_TESS_MIN_LEVEL, SEA_TESS_MAX_LEVEL], the same for ab and ba.
+float seaTessEdgeLevel(const SeaTessView& view, glm::vec3 a, glm::vec3 b);
+
+/// Creates the storage buffer. Needs a GL context.
+void seaTessInit();
+void seaTessShutdown();
+
+/// Uploads count (<= SEA_TESS_MAX_PATCHES) patches and binds the buffer.
+void seaTessUpload(const SeaTessPatch* patches, int count);
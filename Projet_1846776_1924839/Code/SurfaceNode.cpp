@@ -5,7 +5,6 @@
 #include <cstring>
 #include <cstdlib>
 #include <GL/glew.h>
-#include <GLFW/glfw3.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
@@ -13,6 +12,12 @@
 
 #include "Var.h"
 #include "NuanceurProg.h"
+#include "SeaCdlod.h"
+#include "SeaClipmap.h"
+#include "SeaLod.h"
+#include "SeaMemory.h"
+#include "SeaProfile.h"
+#include "SeaTess.h"
 
 struct SurfaceNode
 {
@@ -21,15 +26,10 @@ struct SurfaceNode
 	float height;
 
 	unsigned int vaoId;
+	float morph;  // CDLOD morph of a leaf, set by renderSeaCdlod()
 
 	int type;  // child #, 0 = root
 
-	//tessellation scale
-	float tscale_negx; // negative x edge
-	float tscale_posx; // Positive x edge
-	float tscale_negz; // Negative z edge
-	float tscale_posz; // Positive z edge
-
 	SurfaceNode* parent;
 	SurfaceNode* child1;
 	SurfaceNode* child2;
@@ -48,10 +48,17 @@ GLint   seaSize = 0;
 
 // size of the patch in meters where you stop subdiv a once its w is > cutoff
 #define SURFACE_CUTOFF 25
+#define MAX_SURFACE_NODES SEA_TESS_MAX_PATCHES
 
 SurfaceNode* surfaceTree;
 SurfaceNode* surfaceTreeTail;
 int numSurfaceNodes = 0;
+int numPatchesDrawn = 0;
+
+// Leaves drawn this frame and their tessellation levels, same order
+SurfaceNode* leaves[ MAX_SURFACE_NODES ];
+SeaTessPatch leafLevels[ MAX_SURFACE_NODES ];
+SeaCdlodInstance leafInstances[ MAX_SURFACE_NODES ];
 
 ///From the main
 glm::mat4 sea_M;	    // Model matrix
@@ -61,7 +68,6 @@ glm::mat4 sea_MV;	    // Movel view matrix
 glm::mat4 sea_MVP;		// Model-view-projection matrix
 glm::mat3 sea_N;        // Normal matrix
 
-#define MAX_SURFACE_NODES 500
 GLuint vaos[ MAX_SURFACE_NODES ];
 GLuint vbos[ MAX_SURFACE_NODES ];
 GLsizei nBuffers;
@@ -71,8 +77,8 @@ void clearTree()
 {
 	surfaceTreeTail = surfaceTree;
 
-	glDeleteVertexArrays( nBuffers + 1, vaos );
-	glDeleteBuffers( nBuffers + 1, vbos );
+	seaMemDeleteVertexArrays( nBuffers, vaos );
+	seaMemDeleteBuffers( nBuffers, vbos );
 	nBuffers = 0;
 
 	memset(surfaceTree, 0, MAX_SURFACE_NODES * sizeof(SurfaceNode));
@@ -81,27 +87,29 @@ void clearTree()
 
 void surfaceInit()
 {
-    surfaceTree = (SurfaceNode*)malloc(MAX_SURFACE_NODES * sizeof(SurfaceNode));
+    surfaceTree = (SurfaceNode*)seaMemMalloc(SeaMemTreeNodes, MAX_SURFACE_NODES * sizeof(SurfaceNode));
 
-	glGenBuffers( 1, &sea_ibo );
+	seaMemGenBuffers( SeaMemBuffers, 1, &sea_ibo );
 	unsigned int positions_indexes[] = { 0, 1, 2, 3 };
 	seaSize = sizeof( positions_indexes );
 
 	// Indexes
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, sea_ibo );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( positions_indexes ), positions_indexes, GL_STATIC_DRAW );
+	seaMemBufferData( sea_ibo, GL_ELEMENT_ARRAY_BUFFER, sizeof( positions_indexes ), positions_indexes, GL_STATIC_DRAW );
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
     clearTree();
 }
 
 void surfaceShutdown()
 {
-    free(surfaceTree);
+    seaMemFree(surfaceTree);
     surfaceTree = NULL;
     surfaceTreeTail = NULL;
+    seaMemDeleteBuffers(1, &sea_ibo);
+    sea_ibo = 0;
 
-	glDeleteVertexArrays( nBuffers + 1, vaos );
-	glDeleteBuffers( nBuffers + 1, vbos );
+	seaMemDeleteVertexArrays( nBuffers, vaos );
+	seaMemDeleteBuffers( nBuffers, vbos );
 	nBuffers = 0;
 }
 
@@ -122,15 +130,15 @@ void createNodeVao( SurfaceNode* node )
 	};
 
 	// Generate buffers
-	glGenVertexArrays( 1, &vaos[ nBuffers ] );
+	seaMemGenVertexArrays( SeaMemTreeVbo, 1, &vaos[ nBuffers ] );
 	glBindVertexArray( vaos[ nBuffers ] );
 
-	glGenBuffers( 1, &vbos[ nBuffers ] );
+	seaMemGenBuffers( SeaMemTreeVbo, 1, &vbos[ nBuffers ] );
 
 	// Link buffers and data:
 	// Positions
 	glBindBuffer( GL_ARRAY_BUFFER, vbos[ nBuffers ] );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( positions ), positions, GL_STATIC_DRAW );
+	seaMemBufferData( vbos[ nBuffers ], GL_ARRAY_BUFFER, sizeof( positions ), positions, GL_STATIC_DRAW );
 	glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, 0 );
 
 	// Indexes
@@ -156,10 +164,6 @@ SurfaceNode* createNode(SurfaceNode* parent, int type, float x, float y, float z
     surfaceTreeTail->origin[2] = z;
     surfaceTreeTail->width = w;
     surfaceTreeTail->height = h;
-    surfaceTreeTail->tscale_negx = 1.0;
-	surfaceTreeTail->tscale_negz = 1.0;
-	surfaceTreeTail->tscale_posx = 1.0;
-	surfaceTreeTail->tscale_posz = 1.0;
 	surfaceTreeTail->parent = parent;
 	surfaceTreeTail->north = NULL;
 	surfaceTreeTail->south = NULL;
@@ -169,20 +173,32 @@ SurfaceNode* createNode(SurfaceNode* parent, int type, float x, float y, float z
 	return surfaceTreeTail;
 }
 
+/**
+* Horizontal distance from the camera to the centre of a node, what the
+* subdivision and the CDLOD morph are based on.
+*/
+float nodeDistance(const SurfaceNode* node, glm::vec3 cam_position)
+{
+    return abs(sqrt(pow(cam_position.x - node->origin[0], 2.0) + pow(cam_position.z - node->origin[2], 2.0))); // replace with distance and float3s
+}
+
 /**
 * Determines whether a node should be subdivided based on its distance to the camera.
 * Returns true if the node should be subdivided.
 */
 GLboolean needsSubdivision(SurfaceNode* node, glm::vec3 cam_position)
 {
-    float d = abs(sqrt(pow(cam_position.x - node->origin[0], 2.0) + pow(cam_position.z - node->origin[2], 2.0))); // replace with distance and float3s
+    float d = nodeDistance(node, cam_position);
 
-	// Distance to camera is greater than twice the length of the diagonal
-	// from current origin to corner of current square.
+	// Distance to camera is greater than lodBias (2.5 by default, lowered while
+	// the camera moves, see SeaLod.h)
+	// times the length of the diagonal from current origin to corner of current square.
+	// Foveation (SeaTess.h) only lowers the tessellation levels: the bias has to
+	// keep neighbouring leaves one level apart.
 	// OR
 	// Max recursion level has been hit
 
-    if (d > 2.5 * sqrt(pow(0.5 * node->width, 2.0) + pow(0.5 * node->height, 2.0)) || node->width < SURFACE_CUTOFF)
+    if (d > seaLodBias() * sqrt(pow(0.5 * node->width, 2.0) + pow(0.5 * node->height, 2.0)) || node->width < SURFACE_CUTOFF)
 	{
 		return GL_FALSE;
 	}
@@ -277,10 +293,6 @@ void createTree(float x, float y, float z, float width, float height, glm::vec3
 	surfaceTree->origin[2] = z;
 	surfaceTree->width = width;
 	surfaceTree->height = height;
-	surfaceTree->tscale_negx = 1.0;
-	surfaceTree->tscale_negz = 1.0;
-	surfaceTree->tscale_posx = 1.0;
-	surfaceTree->tscale_posz = 1.0;
 	surfaceTree->parent = NULL;
 	surfaceTree->north = NULL;
 	surfaceTree->south = NULL;
@@ -311,43 +323,121 @@ SurfaceNode* find(SurfaceNode* n, float x, float z)
 }
 
 /**
-* Calculate the tessellation scale factor for a node depending on the neighboring patches.
+* End points of one edge of a node, sides in the order of the quad domain's
+* outer levels: 0 = positive z (north), 1 = positive x (east),
+* 2 = negative z (south), 3 = negative x (west).
+*/
+void nodeEdge(const SurfaceNode* node, int side, glm::vec3& a, glm::vec3& b)
+{
+	float x = node->origin[0], y = node->origin[1], z = node->origin[2];
+	float w = node->width / 2, h = node->height / 2;
+
+	switch (side)
+	{
+	case 0: a = glm::vec3(x - w, y, z + h); b = glm::vec3(x + w, y, z + h); break;
+	case 1: a = glm::vec3(x + w, y, z + h); b = glm::vec3(x + w, y, z - h); break;
+	case 2: a = glm::vec3(x + w, y, z - h); b = glm::vec3(x - w, y, z - h); break;
+	default: a = glm::vec3(x - w, y, z - h); b = glm::vec3(x - w, y, z + h); break;
+	}
+}
+
+/**
+* The leaf on the other side of an edge of a node (sides as in nodeEdge()),
+* or NULL at the border of the tree.
 */
-void calcTessScale(SurfaceNode *node)
+SurfaceNode* findNeighbour(SurfaceNode *node, int side)
 {
-	SurfaceNode *t;
-
-	// Positive Z (north)
-	t = find(surfaceTree, node->origin[0], node->origin[2] + 1 + node->width / 2.0);
-	if (t->width > node->width)
-		node->tscale_posz = 2.0;
-
-	// Positive X (east)
-	t = find(surfaceTree, node->origin[0] + 1 + node->width / 2.0, node->origin[2]);
-	if (t->width > node->width)
-		node->tscale_posx = 2.0;
-
-	// Negative Z (south)
-	t = find(surfaceTree, node->origin[0], node->origin[2] - 1 - node->width / 2.0);
-	if (t->width > node->width)
-		node->tscale_negz = 2.0;
-
-	// Negative X (west)
-	t = find(surfaceTree, node->origin[0] - 1 - node->width / 2.0, node->origin[2]);
-	if (t->width > node->width)
-		node->tscale_negx = 2.0;
+	static const float probeX[4] = { 0, 1, 0, -1 };
+	static const float probeZ[4] = { 1, 0, -1, 0 };
+
+	// the point just past the edge, if it lies inside the leaf found
+	float px = node->origin[0] + probeX[side] * (1 + node->width / 2);
+	float pz = node->origin[2] + probeZ[side] * (1 + node->width / 2);
+	SurfaceNode *t = find(surfaceTree, px, pz);
+	if (fabs(px - t->origin[0]) <= t->width / 2 && fabs(pz - t->origin[2]) <= t->height / 2)
+		return t;
+	return NULL;
 }
 
 /**
-* Pushes a node (patch) to the GPU to be drawn.
-* note: height parameter is here 4but not used. currently only dealing with square terrains (width is used only)
+* Calculate the tessellation levels of a node. An edge shared with a larger
+* neighbour takes half the level of the neighbour's edge, so both sides of
+* the seam put their vertices at the same places. The neighbour is never
+* more than twice as large (SEA_LOD_BIAS_MIN) and its level is at least
+* SEA_TESS_MIN_LEVEL, so the half is an even level of 2 or more: the
+* fractional_even_spacing of the TES keeps it as is.
+* With skirts (CVar::seaSkirts) the neighbours are not looked up: the outer
+* ring only draws the skirt, which needs no more than one segment a side.
 */
-void renderNode(SurfaceNode* node, CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position)
+void calcTessLevels(SurfaceNode *node, const SeaTessView& view, SeaTessPatch& levels)
 {
+	glm::vec3 a, b;
+	float own[4];
+	for (int side = 0; side < 4; side++)
+	{
+		nodeEdge(node, side, a, b);
+		own[side] = seaTessEdgeLevel(view, a, b);
+		levels.outer[side] = own[side];
+
+		if (CVar::seaSkirts)
+		{
+			levels.outer[side] = 1.0f;
+			continue;
+		}
+
+		SurfaceNode *t = findNeighbour(node, side);
+		if (t && t->width > node->width)
+		{
+			nodeEdge(t, (side + 2) % 4, a, b);
+			levels.outer[side] = glm::max(seaTessEdgeLevel(view, a, b) * node->width / t->width, 2.0f);
+		}
+	}
 
-	// Calculate the tess scale factor
-	calcTessScale(node);
+	levels.inner[0] = glm::max(own[1], own[3]);
+	levels.inner[1] = glm::max(own[0], own[2]);
+	levels.padding[0] = levels.padding[1] = 0;
+}
 
+/**
+* CDLOD morph of a leaf (SeaCdlod.h), from the distance to its parent.
+*/
+float cdlodMorph(SurfaceNode *node, glm::vec3 cam_position)
+{
+	if (!node->parent)
+		return 0.0f;
+	return seaCdlodMorph(nodeDistance(node->parent, cam_position), node->width, seaLodBias());
+}
+
+/**
+* Per instance attributes of a leaf for the CDLOD grid (SeaCdlod.h), once
+* every leaf has its morph: an edge along a larger neighbour takes its grid,
+* along a smaller one keeps its own, and along one of the same size takes
+* the larger morph of both.
+*/
+void calcCdlodInstance(SurfaceNode *node, SeaCdlodInstance& instance)
+{
+	instance.bounds = glm::vec4(node->origin[0], node->origin[2], node->width, node->origin[1]);
+	instance.morph = node->morph;
+	for (int side = 0; side < 4; side++)
+	{
+		SurfaceNode *t = findNeighbour(node, side);
+		instance.sides[side] = instance.morph;
+		if (t && t->width > node->width)
+			instance.sides[side] = 1.0f;
+		else if (t && t->width < node->width)
+			instance.sides[side] = 0.0f;
+		else if (t)
+			instance.sides[side] = glm::max(instance.morph, t->morph);
+	}
+}
+
+/**
+* Uniforms shared by every sea patch: matrices, time, wave size and eye position.
+* Set once per frame, before the patches are drawn.
+*/
+void setSeaUniforms(CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position)
+{
+	SeaProfileScope scope("setSeaUniforms");
 	glm::vec3 t( 0.f, -20.f, 0.f );
     sea_MV = glm::mat4();
     sea_M = glm::translate( t );
@@ -385,18 +475,18 @@ void renderNode(SurfaceNode* node, CNuanceurProg& progNuanceurGazon, glm::vec3 c
 	handle = glGetUniformLocation(progNuanceurGazon.getProg(), "waveSize");
 	glUniform1ui( handle, CVar::waveSize );
 
-	// Send patch neighbor edge tess scale factors
-	handle = glGetUniformLocation(progNuanceurGazon.getProg(), "tscale_negx");
-	glUniform1f(handle, node->tscale_negx);
-	handle = glGetUniformLocation(progNuanceurGazon.getProg(), "tscale_negz");
-	glUniform1f(handle, node->tscale_negz);
-	handle = glGetUniformLocation(progNuanceurGazon.getProg(), "tscale_posx");
-	glUniform1f(handle, node->tscale_posx);
-	handle = glGetUniformLocation(progNuanceurGazon.getProg(), "tscale_posz");
-	glUniform1f(handle, node->tscale_posz);
-
 	handle = glGetUniformLocation(progNuanceurGazon.getProg(), "eyePos");
 	glUniform3fv(handle, 1, &cam_position[0]);
+}
+
+/**
+* Pushes a node (patch) to the GPU to be drawn.
+* note: height parameter is here 4but not used. currently only dealing with square terrains (width is used only)
+*/
+void renderNode(SurfaceNode* node, int index, GLint patchIndex)
+{
+	// Entry of the node in the tessellation level buffer (SeaTess.h)
+	glUniform1i(patchIndex, index);
 
 	glBindVertexArray( vaos[ node->vaoId ] );
     if( CVar::isSeaGrid )
@@ -418,14 +508,14 @@ void renderNode(SurfaceNode* node, CNuanceurProg& progNuanceurGazon, glm::vec3 c
 
 
 /**
-* Traverses the terrain quadtree to draw nodes with no children.
+* Traverses the terrain quadtree to collect nodes with no children.
 */
-void renderRecursive(SurfaceNode *node, CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position)
+void collectLeaves(SurfaceNode *node)
 {
-	// If all children are null, render this node
+	// If all children are null, this node is drawn
 	if (!node->child1 && !node->child2 && !node->child3 && !node->child4)
 	{
-		renderNode(node, progNuanceurGazon, cam_position);
+		leaves[numPatchesDrawn++] = node;
 		return;
 	}
 
@@ -434,19 +524,112 @@ void renderRecursive(SurfaceNode *node, CNuanceurProg& progNuanceurGazon, glm::v
 	// either all the children are null or all the children are not null.
 	// There shouldn't be any other cases, but we check here for safety.
 	if (node->child1)
-		renderRecursive(node->child1, progNuanceurGazon, cam_position);
+		collectLeaves(node->child1);
 	if (node->child2)
-		renderRecursive(node->child2, progNuanceurGazon, cam_position);
+		collectLeaves(node->child2);
 	if (node->child3)
-		renderRecursive(node->child3, progNuanceurGazon, cam_position);
+		collectLeaves(node->child3);
 	if (node->child4)
-		renderRecursive(node->child4, progNuanceurGazon, cam_position);
+		collectLeaves(node->child4);
+}
+
+/**
+* CPU side of renderSea(): collects the leaves and computes their
+* tessellation levels. Returns the number of leaves.
+*/
+int surfaceTessLevels()
+{
+	numPatchesDrawn = 0;
+	collectLeaves(surfaceTree);
+
+	SeaProfileScope scope("calcTessLevels");
+	SeaTessView view = seaTessCurrentView(glm::translate(glm::vec3(0.f, -20.f, 0.f)));
+	for (int i = 0; i < numPatchesDrawn; i++)
+		calcTessLevels(leaves[i], view, leafLevels[i]);
+	return numPatchesDrawn;
+}
+
+/**
+* Width of the leaf of the current tree over the model space point (x, z).
+*/
+float surfaceLeafWidth(float x, float z)
+{
+	return find(surfaceTree, x, z)->width;
+}
+
+/**
+* Evaluates needsSubdivision() on every node of the current tree, returns
+* how many would be split.
+*/
+int surfaceSubdivisions(glm::vec3 cam_position)
+{
+	int split = 0;
+	for (int i = 0; i <= numSurfaceNodes; i++)
+		split += needsSubdivision(&surfaceTree[i], cam_position) ? 1 : 0;
+	return split;
 }
 
 /**
-* Draw the terrrain.
+* Draw the terrrain: the tessellation levels of every leaf are computed and
+* uploaded first, then each leaf is drawn with its index in that buffer.
 */
 void renderSea(CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position)
 {
-	renderRecursive(surfaceTree, progNuanceurGazon, cam_position);
-}
\ No newline at end of file
+	surfaceTessLevels();
+
+	seaProfileBegin("seaTessUpload");
+	seaTessUpload(leafLevels, numPatchesDrawn);
+	seaProfileEnd();
+
+	setSeaUniforms(progNuanceurGazon, cam_position);
+	GLint patchIndex = glGetUniformLocation(progNuanceurGazon.getProg(), "patchIndex");
+
+	seaProfileBegin("renderNode");
+	for (int i = 0; i < numPatchesDrawn; i++)
+		renderNode(leaves[i], i, patchIndex);
+	seaProfileEnd();
+}
+
+/**
+* Draw the terrain without tessellation stages: one instanced grid per leaf,
+* morphed in the vertex shader (SeaCdlod.h).
+*/
+void renderSeaCdlod(CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position)
+{
+	numPatchesDrawn = 0;
+	collectLeaves(surfaceTree);
+
+	for (int i = 0; i < numPatchesDrawn; i++)
+		leaves[i]->morph = cdlodMorph(leaves[i], cam_position);
+	for (int i = 0; i < numPatchesDrawn; i++)
+		calcCdlodInstance(leaves[i], leafInstances[i]);
+
+	setSeaUniforms(progNuanceurGazon, cam_position);
+	if( CVar::isSeaGrid )
+		glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+	seaCdlodDraw(leafInstances, numPatchesDrawn);
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+}
+
+/**
+* Draw the sea as nested rings around the camera (SeaClipmap.h). The
+* quadtree is not used.
+*/
+void renderSeaClipmap(CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position)
+{
+	numPatchesDrawn = 0;
+
+	setSeaUniforms(progNuanceurGazon, cam_position);
+	if( CVar::isSeaGrid )
+		glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+	seaClipmapDraw(progNuanceurGazon.getProg(), cam_position);
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+}
+
+/**
+* Patches sent to the GPU by the last renderSea().
+*/
+int surfacePatchesDrawn()
+{
+	return numPatchesDrawn;
+}
@@ -3,5 +3,13 @@
 // https://bitbucket.org/victorbush/ufl.cap5705.terrain/src/master/
 void createTree(float x, float y, float z, float width, float height, glm::vec3 cam_position);
 void renderSea(CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position);
+void renderSeaCdlod(CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position);
+void renderSeaClipmap(CNuanceurProg& progNuanceurGazon, glm::vec3 cam_position);
 void surfaceInit();
-void surfaceShutdown();
\ No newline at end of file
+void surfaceShutdown();
+int surfacePatchesDrawn();
+
+// CPU parts of the sea, also run by the benchmarks (Bench/BenchMain.cpp)
+int surfaceTessLevels();
+float surfaceLeafWidth(float x, float z);
+int surfaceSubdivisions(glm::vec3 cam_position);
\ No newline at end of file
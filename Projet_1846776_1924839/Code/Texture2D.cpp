@@ -7,6 +7,17 @@
 ///
 ///////////////////////////////////////////////////////////////////////////////
 #include "Texture2D.h"
+#include "SeaMemory.h"
+
+///////////////////////////////////////////////////////////////////////////////
+///  Taille en mémoire vidéo d'une texture RGB, pour SeaMemory.h: le RGB est
+///  compté sur 4 octets et les mipmaps ajoutent un tiers
+///////////////////////////////////////////////////////////////////////////////
+static long long tailleTexture(int largeur, int hauteur, bool mipmap)
+{
+    long long octets = 4LL * largeur * hauteur;
+    return mipmap ? octets * 4 / 3 : octets;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 ///  public constructor  CTexture2D \n
@@ -47,6 +58,7 @@ CTexture2D::CTexture2D(vect3D* data, int hauteur, int largeur, bool mipmap)
 {
     // aiguiller openGL vers la zone mémoire contenant le graphisme de la texture
     glTexImage2D(GL_TEXTURE_2D, 0, 3, largeur, hauteur, 0, GL_RGB, GL_FLOAT, data);
+    seaMemTextureSize(nomTexture_, tailleTexture(largeur, hauteur, mipmap));
     if (mipmap)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -93,6 +105,7 @@ void CTexture2D::chargerTexture()
             // aiguiller openGL vers la zone mémoire contenant le graphisme de la texture
             glTexImage2D(GL_TEXTURE_2D, 0, 3, TextureImage.tailleX, TextureImage.tailleY, 0, GL_RGB, GL_UNSIGNED_BYTE,
                          TextureImage.data.data());
+            seaMemTextureSize(nomTexture_, tailleTexture(TextureImage.tailleX, TextureImage.tailleY, mipmap_));
             if (mipmap_)
             {
                 glGenerateMipmap(GL_TEXTURE_2D);
@@ -107,6 +120,7 @@ void CTexture2D::chargerTexture()
     {
         glTexImage2D(GL_TEXTURE_2D, 0, 3, TextureImage.tailleX, TextureImage.tailleY, 0, GL_RGB, GL_UNSIGNED_BYTE,
                      TextureImage.data.data());
+        seaMemTextureSize(nomTexture_, tailleTexture(TextureImage.tailleX, TextureImage.tailleY, mipmap_));
         if (mipmap_)
         {
             glGenerateMipmap(GL_TEXTURE_2D);
@@ -8,6 +8,7 @@
 ///
 ///////////////////////////////////////////////////////////////////////////////
 #include "TextureAbstraite.h"
+#include "SeaMemory.h"
 #include <cstring>
 #include <stdio.h>
 #include <stdlib.h>
@@ -36,7 +37,7 @@ CTextureAbstraite::CTextureAbstraite(const std::string& nomFichier, const GLenum
     if (genTex)
     {
         // créer la texture
-        glGenTextures(1, &nomTexture_);
+        seaMemGenTextures(SeaMemTextures, 1, &nomTexture_);
         glBindTexture(CIBLE_, nomTexture_);
     }
 }
@@ -49,7 +50,7 @@ CTextureAbstraite::CTextureAbstraite(GLenum cible, bool mipmap, bool genTex)
     if (genTex)
     {
         // créer la texture
-        glGenTextures(1, &nomTexture_);
+        seaMemGenTextures(SeaMemTextures, 1, &nomTexture_);
         glBindTexture(CIBLE_, nomTexture_);
     }
 }
@@ -68,7 +69,7 @@ CTextureAbstraite::~CTextureAbstraite(void)
 {
     // destruction du nom de texture associé afin de le libérer pour d'autres textures
     const GLuint textureADetruire = nomTexture_;
-    glDeleteTextures(1, &textureADetruire);
+    seaMemDeleteTextures(1, &textureADetruire);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -304,6 +305,6 @@ int CTextureAbstraite::loadBMP(const std::string& nomFichier, Image* image)
 void CTextureAbstraite::genTex()
 {
     // créer la texture
-    glGenTextures(1, &nomTexture_);
+    seaMemGenTextures(SeaMemTextures, 1, &nomTexture_);
     glBindTexture(CIBLE_, nomTexture_);
 }
@@ -0,0 +1,103 @@
+// Small fixed-size thread pool used to shard CPU batches (wave queries, FFT rows...).
+
+#include "ThreadPool.h"
+
+CThreadPool::CThreadPool(unsigned nThreads)
+    : job_(NULL)
+    , count_(0)
+    , grain_(1)
+    , next_(0)
+    , active_(0)
+    , generation_(0)
+    , stop_(false)
+{
+    if (nThreads == 0)
+        nThreads = std::thread::hardware_concurrency();
+    if (nThreads == 0)
+        nThreads = 1;
+
+    for (unsigned i = 1; i < nThreads; i++)
+        workers_.push_back(std::thread(&CThreadPool::workerLoop, this));
+}
+
+CThreadPool::~CThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (size_t i = 0; i < workers_.size(); i++)
+        workers_[i].join();
+}
+
+unsigned CThreadPool::nbThreads() const
+{
+    return static_cast<unsigned>(workers_.size()) + 1;
+}
+
+void CThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn)
+{
+    if (grain == 0)
+        grain = 1;
+
+    // not worth waking anyone up
+    if (workers_.empty() || count <= grain)
+    {
+        if (count > 0)
+            fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> call(callMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_    = &fn;
+        count_  = count;
+        grain_  = grain;
+        next_   = 0;
+        active_ = static_cast<unsigned>(workers_.size());
+        generation_++;
+    }
+    wake_.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return active_ == 0; });
+    job_ = NULL;
+}
+
+void CThreadPool::workerLoop()
+{
+    unsigned seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_ == 0)
+            done_.notify_one();
+    }
+}
+
+void CThreadPool::runChunks()
+{
+    for (;;)
+    {
+        size_t begin = next_.fetch_add(grain_);
+        if (begin >= count_)
+            return;
+        size_t end = begin + grain_ < count_ ? begin + grain_ : count_;
+        (*job_)(begin, end);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+// Small fixed-size thread pool used to shard CPU batches (wave queries, FFT rows...).
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+///  @class CThreadPool
+///  @brief Fixed set of worker threads running parallelFor() jobs.
+///
+///  @remarks The calling thread takes part in every job, so a pool of
+///           N threads owns N - 1 workers. Jobs from several threads are
+///           serialized.
+///////////////////////////////////////////////////////////////////////////////
+class CThreadPool
+{
+public:
+    /// nThreads == 0 uses every hardware thread
+    explicit CThreadPool(unsigned nThreads = 0);
+    ~CThreadPool();
+
+    /// Number of threads running a job, caller included
+    unsigned nbThreads() const;
+
+    /// Calls fn(begin, end) over [0, count) in chunks of "grain" items and
+    /// returns once every chunk is done.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    CThreadPool(const CThreadPool&);
+    CThreadPool& operator=(const CThreadPool&);
+
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers_;
+
+    std::mutex              callMutex_;
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    const std::function<void(size_t, size_t)>* job_;
+    size_t                                     count_;
+    size_t                                     grain_;
+    std::atomic<size_t>                        next_;
+    unsigned                                   active_;
+    unsigned                                   generation_;
+    bool                                       stop_;
+};
@@ -10,6 +10,7 @@
 #include "Var.h"
 
 #include "Cst.h"
+#include "SeaLod.h"
 #include "ObjParser/MathUtils.h"
 
 using namespace Math3D;
@@ -38,6 +39,24 @@ bool                   CVar::spotLightOn   = true;
 bool                   CVar::showDebugInfo = false;
 bool CVar::isSeaGrid = false;
 GLint CVar::waveSize = 2;
+bool CVar::seaMapOn = true;
+int CVar::seaMapTileBudget = 0;
+int CVar::waveModel = 0;
+int CVar::gerstnerWaveBudget = 32;
+float CVar::pixelsPerTriangle = 16.0f;
+bool CVar::lodAuto = true;
+float CVar::lodTargetMs = 16.6f;
+float CVar::hitchMs = 33.3f;
+float CVar::tessScale = SEA_LOD_SCALE_DEFAULT;
+float CVar::lodBias = SEA_LOD_BIAS_DEFAULT;
+bool CVar::lodMotion = true;
+bool CVar::foveation = false;
+glm::vec2 CVar::foveaGaze = glm::vec2(0.0f);
+float CVar::foveaRadius = 10.0f;
+float CVar::foveaFalloff = 25.0f;
+bool CVar::seaCullOn = true;
+bool CVar::seaSkirts = false;
+int CVar::seaRenderer = 0;
 
 double CVar::theta = Deg2Rad(270.0);
 double CVar::phi   = Deg2Rad(90.0);
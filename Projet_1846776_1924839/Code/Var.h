@@ -139,4 +139,66 @@ public:
     static bool showDebugInfo;
     static bool isSeaGrid;
     static GLint waveSize;
+
+    /// indique si les vagues sont lues de la carte de déplacement (SeaMap.h)
+    /// plutôt que recalculées pour chaque sommet tessellé
+    static bool seaMapOn;
+
+    /// nombre de tuiles de la carte de déplacement recalculées par image
+    /// (0 = toute la carte à chaque image)
+    static int seaMapTileBudget;
+
+    /// modèle de vagues : SEA_WAVE_NOISE (bruit simplex), SEA_WAVE_FFT
+    /// (océan spectral calculé par FFT sur le CPU, SeaFft.h) ou
+    /// SEA_WAVE_GERSTNER (somme de vagues de Gerstner, SeaGerstner.h)
+    static int waveModel;
+
+    /// nombre maximal de vagues de Gerstner évaluées par sommet
+    static int gerstnerWaveBudget;
+
+    /// longueur visée des arêtes des triangles de la mer, en pixels
+    /// (niveaux de tessellation calculés par SeaTess.cpp)
+    static float pixelsPerTriangle;
+
+    /// contrôleur de niveau de détail (SeaLod.h) actif?
+    static bool lodAuto;
+
+    /// temps GPU visé par image, en ms
+    static float lodTargetMs;
+
+    /// durée d'image au-delà de laquelle on compte une saccade (SeaFrameTime.h), en ms
+    static float hitchMs;
+
+    /// multiplicateur de la densité de tessellation (1 = pixelsPerTriangle)
+    static float tessScale;
+
+    /// distance de subdivision du quadtree, en diagonales de la parcelle
+    static float lodBias;
+
+    /// moins de détails quand la caméra se déplace ou tourne vite (SeaLod.h)?
+    static bool lodMotion;
+
+    /// tessellation fovéale: moins de détails loin du point regardé (SeaTess.h)?
+    static bool foveation;
+
+    /// point regardé, en coordonnées normalisées de l'écran (0, 0 = centre)
+    static glm::vec2 foveaGaze;
+
+    /// demi-angle de pleine résolution autour du point regardé, en degrés
+    static float foveaRadius;
+
+    /// angle supplémentaire pour atteindre la résolution minimale, en degrés
+    static float foveaFalloff;
+
+    /// élimination des parcelles hors du champ de vue dans nuanceurTessCtrl.glsl?
+    static bool seaCullOn;
+
+    /// jupes le long des bords des parcelles au lieu de niveaux de tessellation
+    /// accordés avec les voisines (nuanceurTessEval.glsl)?
+    static bool seaSkirts;
+
+    /// rendu de la mer: SEA_RENDER_TESS (nuanceurs de tessellation),
+    /// SEA_RENDER_CDLOD (grille instanciée, voir SeaCdlod.h) ou
+    /// SEA_RENDER_CLIPMAP (anneaux imbriqués, voir SeaClipmap.h)
+    static int seaRenderer;
 };
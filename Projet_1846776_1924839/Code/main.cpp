@@ -11,6 +11,7 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 
 #include <GL/glew.h>
@@ -30,6 +31,22 @@
 #include "Var.h"
 #include "textfile.h"
 #include "SurfaceNode.h"
+#include "SeaBench.h"
+#include "SeaCdlod.h"
+#include "SeaClipmap.h"
+#include "SeaCull.h"
+#include "SeaFft.h"
+#include "SeaFrameTime.h"
+#include "SeaGerstner.h"
+#include "SeaLod.h"
+#include "SeaMemory.h"
+#include "SeaProfile.h"
+#include "SeaReplay.h"
+#include "SeaStats.h"
+#include "SeaTess.h"
+#include "SeaMap.h"
+#include "SeaNoise.h"
+#include "SeaQuery.h"
 
 #include <string>
 
@@ -42,6 +59,8 @@ using namespace Math3D;
 // Shaders
 static CNuanceurProg progNuanceurSea( "Nuanceurs/seaSommets.glsl", "Nuanceurs/seaFragments.glsl", 
                                       "Nuanceurs/nuanceurTessCtrl.glsl", "Nuanceurs/nuanceurTessEval.glsl", false );
+static CNuanceurProg progNuanceurSeaCdlod( "Nuanceurs/seaCdlodSommets.glsl", "Nuanceurs/seaFragments.glsl", false );
+static CNuanceurProg progNuanceurSeaClipmap( "Nuanceurs/seaClipmapSommets.glsl", "Nuanceurs/seaFragments.glsl", false );
 
 // Camera Attributes
 static float horizontalAngle = 0.f;
@@ -56,12 +75,26 @@ static glm::vec3 direction    = glm::vec3(0.f, 0.f, -1.0f);
 static glm::vec3 cam_right    = glm::vec3(1.f, 0.f, 0.f);
 static glm::vec3 cam_up       = glm::vec3(0.f, 1.f, 0.f);
 
+// Caméra au pas de simulation précédent, et celle de l'image, interpolée entre les deux
+static glm::vec3 sim_prev_position   = glm::vec3(0, 0, 0);
+static float     sim_prev_horizontal = 0.f;
+static float     sim_prev_vertical   = 0.f;
+static glm::vec3 view_position       = glm::vec3(0, 0, 0);
+
+// Déplacement de la souris pas encore appliqué par un pas de simulation
+static double mouseDx = 0.0;
+static double mouseDy = 0.0;
+
 // Models matrix
 static glm::mat4 seaModelMatrix;
 
 // Debug tessellation levels
 static GLboolean stopComputingTree = false;
 
+// Cible du rendu: 0 = la fenêtre, le framebuffer de SeaBench.h avec --benchmark
+static GLuint sceneFramebuffer = 0;
+
+
 ///////////////////////////////////////////////
 // PROTOTYPES DES FONCTIONS DU MAIN          //
 ///////////////////////////////////////////////
@@ -70,21 +103,173 @@ void      drawScene(void);
 glm::mat4 getModelMatrixSea(void);
 void      setLightsAttributes(const GLuint progNuanceur);
 void      keyboard(GLFWwindow* fenetre, int touche, int scancode, int action, int mods);
-void      mouseMovement(GLFWwindow* window, double deltaT, glm::vec3& direction, glm::vec3& right, glm::vec3& up);
+void      pollMouse(GLFWwindow* window);
+void      mouseMovement(double deltaT, double part, glm::vec3& direction, glm::vec3& right, glm::vec3& up);
+void      cameraAxes(float horizontal, float vertical, glm::vec3& direction, glm::vec3& right, glm::vec3& up);
 void      resize(GLFWwindow* fenetre, int w, int h);
-void      refreshCamera(GLFWwindow* window, double deltaT);
+void      refreshCamera(GLFWwindow* window, double deltaT, double mousePart);
+void      refreshView(double alpha);
 void      compileShaders();
+void      benchmarkRenderers(GLFWwindow* fenetre);
+bool      benchmarkPath(GLFWwindow* fenetre, const char* rapport);
 
 // le main
-int main(int /*argc*/, char* /*argv*/[])
+int main(int argc, char* argv[])
 {
+    // mesure des noyaux CPU des vagues, sans contexte openGL
+    bool        benchRenderers = false;
+    const char* benchPath      = nullptr;
+    const char* benchJson      = "benchmark.json";
+    const char* frameTimesCsv  = "temps_images.csv";
+    bool        benchOsMesa    = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bench-noise") == 0)
+        {
+            seaNoiseBenchmark(1 << 20);
+            return EXIT_SUCCESS;
+        }
+        if (strcmp(argv[i], "--bench-query") == 0)
+        {
+            seaQueryBenchmark(getModelMatrixSea(), 1 << 20);
+            return EXIT_SUCCESS;
+        }
+        if (strcmp(argv[i], "--bench-fft") == 0)
+        {
+            seaFftBenchmark();
+            return EXIT_SUCCESS;
+        }
+        if (strcmp(argv[i], "--lod-log") == 0 && i + 1 < argc)
+        {
+            if (!seaLodOpenLog(argv[++i]))
+                printf("Impossible d'ouvrir %s\n", argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--stats-log") == 0 && i + 1 < argc)
+        {
+            if (!seaStatsOpenLog(argv[++i]))
+                printf("Impossible d'ouvrir %s\n", argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--frame-times") == 0 && i + 1 < argc)
+        {
+            frameTimesCsv = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            if (!seaProfileOpenTrace(argv[++i]))
+                printf("Impossible d'ouvrir %s\n", argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            if (!seaReplayRecord(argv[++i]))
+                printf("Impossible d'ouvrir %s\n", argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            if (!seaReplayOpen(argv[++i]))
+                printf("Impossible de lire l'enregistrement %s\n", argv[i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--cdlod") == 0)
+        {
+            CVar::seaRenderer = SEA_RENDER_CDLOD;
+            continue;
+        }
+        if (strcmp(argv[i], "--clipmap") == 0)
+        {
+            CVar::seaRenderer = SEA_RENDER_CLIPMAP;
+            continue;
+        }
+        if (strcmp(argv[i], "--skirts") == 0)
+        {
+            CVar::seaSkirts = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--fovea") == 0 && i + 2 < argc)
+        {
+            CVar::foveation   = true;
+            CVar::foveaGaze.x = float(atof(argv[++i]));
+            CVar::foveaGaze.y = float(atof(argv[++i]));
+            continue;
+        }
+        if (strcmp(argv[i], "--fovea-falloff") == 0 && i + 2 < argc)
+        {
+            CVar::foveaRadius  = float(atof(argv[++i]));
+            CVar::foveaFalloff = float(atof(argv[++i]));
+            continue;
+        }
+        if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+        {
+            benchPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            benchJson = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--osmesa") == 0)
+        {
+            benchOsMesa = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--bench-renderers") == 0)
+        {
+            benchRenderers = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--bench-gerstner") == 0)
+        {
+            seaGerstnerBenchmark(1 << 20);
+            return EXIT_SUCCESS;
+        }
+    }
+
+    if (benchPath && !seaBenchLoadPath(benchPath))
+        return 1;
+
+#ifdef GLFW_PLATFORM_NULL
+    // sans serveur d'affichage: la plateforme nulle de GLFW 3.4, contexte EGL ou OSMesa
+    if (benchPath)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+
     // start GL context and O/S window using the GLFW helper library
     if (!glfwInit())
     {
         fprintf(stderr, "ERREUR: impossible d'initialiser GLFW3\n");
+#ifndef GLFW_PLATFORM_NULL
+        // avant GLFW 3.4, le banc d'essai a besoin d'un serveur d'affichage
+        if (benchPath)
+            fprintf(stderr, "ERREUR: --benchmark sans affichage demande GLFW 3.4, compile avec GLFW %d.%d\n",
+                    GLFW_VERSION_MAJOR, GLFW_VERSION_MINOR);
+#endif
         return 1;
     }
 
+    // banc d'essai: fenêtre invisible, contexte hors écran de taille fixe
+    if (benchPath)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_OSMESA_CONTEXT_API
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, benchOsMesa ? GLFW_OSMESA_CONTEXT_API : GLFW_EGL_CONTEXT_API);
+#else
+        if (benchOsMesa)
+            printf("OSMesa demande GLFW 3.3, contexte EGL\n");
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+#endif
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glewExperimental = GL_TRUE;
+        CVar::currentW   = SEA_BENCH_WIDTH;
+        CVar::currentH   = SEA_BENCH_HEIGHT;
+    }
+
     GLFWwindow* fenetre = glfwCreateWindow(CVar::currentW, CVar::currentH, "INF8702 - Labo", nullptr, nullptr);
     if (!fenetre)
     {
@@ -171,17 +356,41 @@ int main(int /*argc*/, char* /*argv*/[])
     // initialisation de variables d'état openGL et création des listes
     initialisation();
 
+    // chemin de caméra scripté hors écran, rapport JSON, puis on quitte
+    int resultat = EXIT_SUCCESS;
+    if (benchPath)
+    {
+        if (!benchmarkPath(fenetre, benchJson))
+            resultat = 1;
+        glfwSetWindowShouldClose(fenetre, GLFW_TRUE);
+    }
+
+    // comparaison des deux rendus de la mer, puis on quitte
+    else if (benchRenderers)
+    {
+        benchmarkRenderers(fenetre);
+        glfwSetWindowShouldClose(fenetre, GLFW_TRUE);
+    }
 
-    double dernierTemps = glfwGetTime();
-    int    nbFrames     = 0;
+
+    double dernierTemps   = glfwGetTime();
+    int    nbFrames       = 0;
+    long   nbImages       = 0;
+    double tempsPrecedent = 0.0;
+    double tempsSimule    = 0.0;
+    double accumulateur   = 0.0;
 
     // boucle principale de gestion des evenements
     while (!glfwWindowShouldClose(fenetre))
     {
+        // fin de l'enregistrement rejoue
+        if (!seaReplayBeginFrame())
+            break;
+
         // Temps ecoule en secondes depuis l'initialisation de GLFW
-        double temps  = glfwGetTime();
-        double deltaT = temps - CVar::temps;
-        CVar::temps   = temps;
+        double temps   = seaReplayTime(glfwGetTime());
+        double deltaT  = temps - tempsPrecedent;
+        tempsPrecedent = temps;
 
         nbFrames++;
         // Si ça fait une seconde que l'on a pas affiché les infos
@@ -189,23 +398,80 @@ int main(int /*argc*/, char* /*argv*/[])
         {
             if (CVar::showDebugInfo)
             {
-                printf("%f ms/frame\n", 1000.0 / double(nbFrames));
+                seaFrameTimePrint();
                 printf("Position: (%f,%f,%f)\n", cam_position.x, cam_position.y, cam_position.z);
+
+                glm::vec2 camXZ(cam_position.x, cam_position.z);
+                float     waterHeight;
+                seaQueryHeights(&camXZ, 1, float(CVar::temps), &waterHeight);
+                printf("Hauteur de l'eau sous la camera: %f\n", waterHeight);
+                printf("Tuiles de la carte des vagues: %d / image\n", seaMapTilesBaked());
+                printf("Parcelles: %d dessinees, %d eliminees par le GPU\n", surfacePatchesDrawn(),
+                       seaCullCulledPatches());
+                printf("GPU: %.2f ms (cible %.1f ms), tessScale %.2f, lodBias %.2f, mouvement %.2f\n",
+                       seaLodGpuMs(), CVar::lodTargetMs, seaLodTessScale(), seaLodBias(), seaLodMotionFactor());
+                seaStatsPrint();
+                seaMemPrint();
             }
             nbFrames = 0;
             dernierTemps += 1.0;
         }
 
-        // Rafraichir le point de vue selon les input clavier et souris
-        refreshCamera(fenetre, deltaT);
+        // Simulation à pas fixe: caméra et temps des vagues avancent de CCst::pasSimulation,
+        // autant de fois que le temps écoulé le permet. Une image trop lente en rattrape
+        // au plus CCst::pasSimulationMax, le reste est perdu plutôt que de s'accumuler.
+        double debutImage = glfwGetTime();
+        seaProfileBegin("refreshCamera");
+        pollMouse(fenetre);
+        accumulateur += std::min(deltaT, CCst::pasSimulationMax * CCst::pasSimulation);
+        // le déplacement de la souris de l'image est réparti sur ses pas
+        int pas = static_cast<int>(accumulateur / CCst::pasSimulation);
+        for (int i = 0; i < pas; i++)
+        {
+            refreshCamera(fenetre, CCst::pasSimulation, 1.0 / (pas - i));
+            tempsSimule += CCst::pasSimulation;
+            accumulateur -= CCst::pasSimulation;
+        }
+
+        // l'image montre l'état entre les deux derniers pas
+        double alpha = accumulateur / CCst::pasSimulation;
+        CVar::temps  = tempsSimule - (1.0 - alpha) * CCst::pasSimulation;
+        refreshView(alpha);
+        seaProfileEnd();
 
         // Afficher nos modèlests
+        seaLodBeginFrame();
         drawScene();
+        seaLodEndFrame(deltaT * 1000.0);
+        double cpuImage = (glfwGetTime() - debutImage) * 1000.0;
+        seaMemFrame();
 
         // Swap buffers
+        seaProfileBegin("swap");
         glfwSwapBuffers(fenetre);
+        seaProfileEnd();
+        seaProfileFrame();
         glfwPollEvents();
+        seaReplayEndFrame(fenetre, keyboard);
+
+        // la première image compte aussi l'initialisation
+        if (nbImages++ > 0)
+            seaFrameTimeAdd(deltaT * 1000.0, cpuImage, seaLodLastGpuMs());
     }
+    seaProfileShutdown();
+    seaReplayShutdown();
+    if (nbImages > 0 && !seaFrameTimeWriteCsv(frameTimesCsv))
+        printf("Impossible d'ecrire %s\n", frameTimesCsv);
+    seaMapShutdown();
+    seaFftShutdown();
+    seaGerstnerShutdown();
+    seaStatsShutdown();
+    seaLodShutdown();
+    seaCullShutdown();
+    seaTessShutdown();
+    seaCdlodShutdown();
+    seaClipmapShutdown();
+
     // close GL context and any other GLFW resources
     glfwTerminate();
 
@@ -214,9 +480,10 @@ int main(int /*argc*/, char* /*argv*/[])
     delete CVar::lumieres[ENUM_LUM::LumDirectionnelle];
     delete CVar::lumieres[ENUM_LUM::LumSpot];
     surfaceShutdown();
+    seaQueryShutdown();
 
     // le programme n'arrivera jamais jusqu'ici
-    return EXIT_SUCCESS;
+    return resultat;
 }
 
 void attribuerValeursMateriel( const GLuint progNuanceur )
@@ -224,19 +491,19 @@ void attribuerValeursMateriel( const GLuint progNuanceur )
     GLint handle;
     GLfloat component[ 4 ] = { 0.15f , 0.26f , 0.55f , 1.0f };
 
-    handle = glGetUniformLocation( progNuanceurSea.getProg(), "Material.Ambient" );
+    handle = glGetUniformLocation( progNuanceur, "Material.Ambient" );
     glUniform4fv( handle, 1, component );
 
-    handle = glGetUniformLocation( progNuanceurSea.getProg(), "Material.Diffuse" );
+    handle = glGetUniformLocation( progNuanceur, "Material.Diffuse" );
     glUniform4fv( handle, 1, component );
 
-    handle = glGetUniformLocation( progNuanceurSea.getProg(), "Material.Specular" );
+    handle = glGetUniformLocation( progNuanceur, "Material.Specular" );
     glUniform4fv( handle, 1, component );
 
-    handle = glGetUniformLocation( progNuanceurSea.getProg(), "Material.Exponent" );
+    handle = glGetUniformLocation( progNuanceur, "Material.Exponent" );
     glUniform4fv( handle, 1, component );
 
-    handle = glGetUniformLocation( progNuanceurSea.getProg(), "Material.Shininess" );
+    handle = glGetUniformLocation( progNuanceur, "Material.Shininess" );
     glUniform1f( handle, 100.f );
 }
 
@@ -349,8 +616,19 @@ void initialisation(void)
             0.0f, true);
     
     seaModelMatrix = getModelMatrixSea();
+    seaQueryInit(seaModelMatrix);
 
     surfaceInit();
+    seaMapInit();
+    seaFftInit(seaFftDefaultParams());
+    seaGerstnerInit();
+    seaStatsInit();
+    seaLodInit();
+    seaProfileInit();
+    seaCullInit();
+    seaTessInit();
+    seaCdlodInit();
+    seaClipmapInit();
 
     // fixer la couleur de fond
     glClearColor(0.0, 0.0, 0.0, 1.0);
@@ -396,23 +674,71 @@ glm::mat4 getModelMatrixSea(void)
 void drawScene()
 {
     //////////////////	 Préparer l'affichage:	//////////////////
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glViewport(0, 0, CVar::currentW, CVar::currentH);
-    
 
-    //////////////////     Afficher les objets:  ///////////////////////////
-    glUseProgram(progNuanceurSea.getProg());
-    attribuerValeursLumieres( progNuanceurSea.getProg() );
-    attribuerValeursMateriel( progNuanceurSea.getProg() );
+    // hauteurs et normales des vagues calculées une seule fois pour l'image
+    seaProfileBegin("vagues");
+    seaProfileGpuBegin("vagues");
+    seaMapUpdate(view_position, float(CVar::temps));
+    if (CVar::waveModel == SEA_WAVE_FFT)
+    {
+        seaFftUpdate(float(CVar::temps));
+        seaFftUpload();
+    }
+    if (CVar::waveModel == SEA_WAVE_GERSTNER)
+        seaGerstnerUpdate(float(CVar::temps));
+    seaProfileGpuEnd();
+    seaProfileEnd();
 
-    if( !stopComputingTree )
+    //////////////////     Afficher les objets:  ///////////////////////////
+    CNuanceurProg& prog = CVar::seaRenderer == SEA_RENDER_CDLOD     ? progNuanceurSeaCdlod
+                        : CVar::seaRenderer == SEA_RENDER_CLIPMAP ? progNuanceurSeaClipmap
+                                                                  : progNuanceurSea;
+    seaProfileBegin("uniformes");
+    glUseProgram(prog.getProg());
+    attribuerValeursLumieres( prog.getProg() );
+    attribuerValeursMateriel( prog.getProg() );
+    seaMapBind( prog.getProg(), 0 );
+    seaFftBind( prog.getProg(), 1, 2 );
+    seaGerstnerBind( prog.getProg(), CVar::projection, CVar::currentH );
+
+    // jusqu'où les vagues peuvent déplacer la surface, pour l'élimination des parcelles
+    glm::vec3 bounds(0.0f, -0.1f * CVar::waveSize, 1.1f * CVar::waveSize);
+    if (CVar::waveModel == SEA_WAVE_FFT)
+        bounds = seaFftBounds();
+    else if (CVar::waveModel == SEA_WAVE_GERSTNER)
+        bounds = seaGerstnerBounds(CVar::gerstnerWaveBudget);
+    seaCullBind( prog.getProg(), bounds );
+
+    // les jupes couvrent tout l'écart de hauteur possible entre deux parcelles voisines
+    glUniform1f( glGetUniformLocation( prog.getProg(), "skirtDepth" ),
+                 CVar::seaSkirts ? bounds.z - bounds.y + 0.1f : 0.0f );
+    glUniform1i( glGetUniformLocation( prog.getProg(), "waveModel" ), CVar::waveModel );
+    seaProfileEnd();
+
+    // le clipmap n'utilise pas le quadtree
+    if( !stopComputingTree && CVar::seaRenderer != SEA_RENDER_CLIPMAP )
     {
+        SeaProfileScope scope("createTree");
         if( !glm::all( glm::equal( cam_position, prev_cam_position ) ) );
-            createTree( 0, 0, 0, 1000, 1000, cam_position );
+            createTree( 0, 0, 0, 1000, 1000, view_position );
     }
 
-    renderSea(progNuanceurSea, cam_position);
+    seaProfileBegin("mer");
+    seaProfileGpuBegin("mer");
+    seaStatsBegin();
+    if (CVar::seaRenderer == SEA_RENDER_CDLOD)
+        renderSeaCdlod(prog, view_position);
+    else if (CVar::seaRenderer == SEA_RENDER_CLIPMAP)
+        renderSeaClipmap(prog, view_position);
+    else
+        renderSea(prog, view_position);
+    seaStatsEnd();
+    seaProfileGpuEnd();
+    seaProfileEnd();
+    seaCullEndFrame();
     // Flush les derniers vertex du pipeline graphique
     glFlush();
 }
@@ -434,8 +760,12 @@ void drawScene()
 ///  @date   2016-06-03
 ///
 ///////////////////////////////////////////////////////////////////////////////
-void keyboard(GLFWwindow* fenetre, int touche, int /* scancode */, int action, int /* mods */)
+void keyboard(GLFWwindow* fenetre, int touche, int scancode, int action, int mods)
 {
+    // pendant la relecture, seules les touches enregistrées comptent, sauf pour quitter
+    if (!seaReplayKeyEvent(touche, scancode, action, mods) && touche != GLFW_KEY_Q && touche != GLFW_KEY_ESCAPE)
+        return;
+
     switch (touche)
     {
     case GLFW_KEY_Q:
@@ -558,6 +888,17 @@ void keyboard(GLFWwindow* fenetre, int touche, int /* scancode */, int action, i
         break;
     }
 
+    case GLFW_KEY_4:
+    {
+        if (action == GLFW_PRESS)
+        {
+            CVar::foveation = !CVar::foveation;
+            std::cout << "foveation = " << CVar::foveation;
+            std::cout << "\n";
+        }
+        break;
+    }
+
     // permuter le minFilter
     case GLFW_KEY_N:
     {
@@ -602,6 +943,126 @@ void keyboard(GLFWwindow* fenetre, int touche, int /* scancode */, int action, i
         }
         break;
     }
+    case GLFW_KEY_K:
+    {
+        if (action == GLFW_PRESS)
+        {
+            CVar::seaMapOn = !CVar::seaMapOn;
+            std::cout << "seaMapOn = " << CVar::seaMapOn;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_J:
+    {
+        // budget de tuiles par image : 0 (tout), 2, 4, 8, 16
+        if (action == GLFW_PRESS)
+        {
+            if (CVar::seaMapTileBudget >= 16)
+                CVar::seaMapTileBudget = 0;
+            else if (CVar::seaMapTileBudget == 0)
+                CVar::seaMapTileBudget = 2;
+            else
+                CVar::seaMapTileBudget *= 2;
+            std::cout << "seaMapTileBudget = " << CVar::seaMapTileBudget;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_V:
+    {
+        // bruit simplex -> océan spectral (FFT) -> vagues de Gerstner
+        if (action == GLFW_PRESS)
+        {
+            CVar::waveModel = (CVar::waveModel + 1) % (SEA_WAVE_GERSTNER + 1);
+            std::cout << "waveModel = " << CVar::waveModel;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_H:
+    {
+        // vagues de Gerstner évaluées au plus : 4, 8, 16, 32
+        if (action == GLFW_PRESS)
+        {
+            CVar::gerstnerWaveBudget *= 2;
+            if (CVar::gerstnerWaveBudget > SEA_GERSTNER_MAX_WAVES)
+                CVar::gerstnerWaveBudget = 4;
+            std::cout << "gerstnerWaveBudget = " << CVar::gerstnerWaveBudget;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_O:
+    {
+        // longueur visée des arêtes en pixels : 2, 4, 8, 16, 32
+        if (action == GLFW_PRESS)
+        {
+            CVar::pixelsPerTriangle *= 2.0f;
+            if (CVar::pixelsPerTriangle > 32.0f)
+                CVar::pixelsPerTriangle = 2.0f;
+            std::cout << "pixelsPerTriangle = " << CVar::pixelsPerTriangle;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_L:
+    {
+        // contrôleur de niveau de détail; désactivé, on revient aux valeurs par défaut
+        if (action == GLFW_PRESS)
+        {
+            CVar::lodAuto = !CVar::lodAuto;
+            if (!CVar::lodAuto)
+            {
+                CVar::tessScale = SEA_LOD_SCALE_DEFAULT;
+                CVar::lodBias   = SEA_LOD_BIAS_DEFAULT;
+            }
+            std::cout << "lodAuto = " << CVar::lodAuto;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_R:
+    {
+        // nuanceurs de tessellation -> grille instanciée (SeaCdlod.h) -> clipmap (SeaClipmap.h)
+        if (action == GLFW_PRESS)
+        {
+            CVar::seaRenderer = (CVar::seaRenderer + 1) % (SEA_RENDER_CLIPMAP + 1);
+            std::cout << "seaRenderer = " << CVar::seaRenderer;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_Z:
+    {
+        if (action == GLFW_PRESS)
+        {
+            CVar::lodMotion = !CVar::lodMotion;
+            std::cout << "lodMotion = " << CVar::lodMotion;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_E:
+    {
+        if (action == GLFW_PRESS)
+        {
+            CVar::seaSkirts = !CVar::seaSkirts;
+            std::cout << "seaSkirts = " << CVar::seaSkirts;
+            std::cout << "\n";
+        }
+        break;
+    }
+    case GLFW_KEY_X:
+    {
+        if (action == GLFW_PRESS)
+        {
+            CVar::seaCullOn = !CVar::seaCullOn;
+            std::cout << "seaCullOn = " << CVar::seaCullOn;
+            std::cout << "\n";
+        }
+        break;
+    }
     case GLFW_KEY_U:
     {
         if (action == GLFW_PRESS)
@@ -717,34 +1178,58 @@ void setLightsAttributes(const GLuint progNuanceur)
 ////////////  FONCTIONS POUR LA SOURIS ///////////////////
 //////////////////////////////////////////////////////////
 
-void mouseMovement(GLFWwindow* window, double deltaT, glm::vec3& direction, glm::vec3& right, glm::vec3& up)
+// Lit le déplacement de la souris une fois par image, les pas de simulation l'appliquent
+void pollMouse(GLFWwindow* window)
 {
-    if (CVar::mouseControl)
-    {
-        // Déplacement de la souris:
-        // Taille actuelle de la fenetre
-        int mid_width, mid_height;
-        glfwGetWindowSize(window, &mid_width, &mid_height);
-        mid_width /= 2;
-        mid_height /= 2;
+    if (!CVar::mouseControl)
+        return;
+
+    // Taille actuelle de la fenetre
+    int mid_width, mid_height;
+    glfwGetWindowSize(window, &mid_width, &mid_height);
+    mid_width /= 2;
+    mid_height /= 2;
 
-        // Get mouse position
-        double xpos, ypos;
-        glfwGetCursorPos(window, &xpos, &ypos);
+    // Get mouse position
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
 
-        // Reset mouse position for next frame
-        glfwSetCursorPos(window, mid_width, mid_height);
+    // Reset mouse position for next frame
+    glfwSetCursorPos(window, mid_width, mid_height);
 
-        // Nouvelle orientation
-        horizontalAngle += mouseSpeed * float(deltaT * (mid_width - xpos));
-        verticalAngle += mouseSpeed * float(deltaT * (mid_height - ypos));
+    double dx = mid_width - xpos, dy = mid_height - ypos;
+    seaReplayMouse(dx, dy);
+    mouseDx += dx;
+    mouseDy += dy;
+}
+
+// Applique la fraction part du déplacement lu par pollMouse() qui reste à faire
+void mouseMovement(double deltaT, double part, glm::vec3& direction, glm::vec3& right, glm::vec3& up)
+{
+    if (CVar::mouseControl)
+    {
+        double dx = mouseDx * part, dy = mouseDy * part;
+        mouseDx -= dx;
+        mouseDy -= dy;
+        horizontalAngle += mouseSpeed * float(deltaT * dx);
+        verticalAngle += mouseSpeed * float(deltaT * dy);
+    }
+    else
+    {
+        mouseDx = 0.0;
+        mouseDy = 0.0;
     }
+    cameraAxes(horizontalAngle, verticalAngle, direction, right, up);
+}
+
+void cameraAxes(float horizontal, float vertical, glm::vec3& direction, glm::vec3& right, glm::vec3& up)
+{
     // Direction : Spherical coordinates to Cartesian coordinates conversion
-    direction = glm::vec3(std::cos(verticalAngle) * std::sin(horizontalAngle), std::sin(verticalAngle),
-                          std::cos(verticalAngle) * std::cos(horizontalAngle));
+    direction = glm::vec3(std::cos(vertical) * std::sin(horizontal), std::sin(vertical),
+                          std::cos(vertical) * std::cos(horizontal));
 
     // Right vector
-    right = glm::vec3(std::sin(horizontalAngle - 3.14f / 2.0f), 0, std::cos(horizontalAngle - 3.14f / 2.0f));
+    right = glm::vec3(std::sin(horizontal - 3.14f / 2.0f), 0, std::cos(horizontal - 3.14f / 2.0f));
 
     // Up vector : perpendicular to both direction and right
     up = glm::cross(right, direction);
@@ -756,42 +1241,68 @@ void mouseMovement(GLFWwindow* window, double deltaT, glm::vec3& direction, glm:
 
 ///////////////////////////////////////////////////////////////////////////////
 ///  @brief Fonction de gestion de la position de la caméra en coordonnées sphériques.
-///  Elle s'occuper de trouver les coordonnées x et y de la caméra à partir
-///  des theta et phi courants, puis fixe dans openGL la position de la caméra
-///  à l'aide de gluLookAt().
+///  Elle avance la caméra d'un pas de simulation de deltaT selon la souris et
+///  le clavier, le pas prenant la fraction mousePart du déplacement de la
+///  souris qui reste. Les matrices de l'image sont fixées ensuite par refreshView().
 ///
 ///  @author Frédéric Plourde
 ///  @date   2007-12-14
 ///////////////////////////////////////////////////////////////////////////////
-void refreshCamera(GLFWwindow* fenetre, double deltaT)
+void refreshCamera(GLFWwindow* fenetre, double deltaT, double mousePart)
 {
-    mouseMovement(fenetre, deltaT, direction, cam_right, cam_up);
+    glm::vec3 startPosition  = cam_position;
+    glm::vec3 startDirection = direction;
+    sim_prev_position        = cam_position;
+    sim_prev_horizontal      = horizontalAngle;
+    sim_prev_vertical        = verticalAngle;
+    mouseMovement(deltaT, mousePart, direction, cam_right, cam_up);
 
     // Move forward
-    if (glfwGetKey(fenetre, GLFW_KEY_W) == GLFW_PRESS)
+    if (seaReplayKey(GLFW_KEY_W, glfwGetKey(fenetre, GLFW_KEY_W)) == GLFW_PRESS)
     {
         prev_cam_position = cam_position;
         cam_position += direction * (float)deltaT * cameraSpeed;
     }
     // Move backward
-    if (glfwGetKey(fenetre, GLFW_KEY_S) == GLFW_PRESS)
+    if (seaReplayKey(GLFW_KEY_S, glfwGetKey(fenetre, GLFW_KEY_S)) == GLFW_PRESS)
     {
         prev_cam_position = cam_position;
         cam_position -= direction * (float)deltaT * cameraSpeed;
     }
     // Strafe right
-    if (glfwGetKey(fenetre, GLFW_KEY_D) == GLFW_PRESS)
+    if (seaReplayKey(GLFW_KEY_D, glfwGetKey(fenetre, GLFW_KEY_D)) == GLFW_PRESS)
     {
         prev_cam_position = cam_position;
         cam_position += cam_right * (float)deltaT * cameraSpeed;
     }
     // Strafe left
-    if (glfwGetKey(fenetre, GLFW_KEY_A) == GLFW_PRESS)
+    if (seaReplayKey(GLFW_KEY_A, glfwGetKey(fenetre, GLFW_KEY_A)) == GLFW_PRESS)
     {
         prev_cam_position = cam_position;
         cam_position -= cam_right * (float)deltaT * cameraSpeed;
     }
 
+    // vitesse de la caméra pour le niveau de détail (SeaLod.h)
+    if (deltaT > 0.0)
+    {
+        float turn = std::acos(glm::clamp(glm::dot(glm::normalize(startDirection), direction), -1.0f, 1.0f));
+        seaLodMotion(glm::length(cam_position - startPosition) / float(deltaT), turn / float(deltaT), deltaT);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///  @brief Matrices de projection et de vue de l'image: la caméra est
+///  interpolée entre le pas de simulation précédent (alpha = 0) et le
+///  dernier (alpha = 1) de refreshCamera().
+///////////////////////////////////////////////////////////////////////////////
+void refreshView(double alpha)
+{
+    float     a = static_cast<float>(alpha);
+    glm::vec3 viewDirection, viewRight, viewUp;
+    view_position = glm::mix(sim_prev_position, cam_position, a);
+    cameraAxes(glm::mix(sim_prev_horizontal, horizontalAngle, a), glm::mix(sim_prev_vertical, verticalAngle, a),
+               viewDirection, viewRight, viewUp);
+
     // Matrice de projection:
     float ratio = static_cast<float>(CVar::currentW) / CVar::currentH;
     if (CVar::isPerspective)
@@ -807,9 +1318,9 @@ void refreshCamera(GLFWwindow* fenetre, double deltaT)
     }
 
     // Matrice de vue:
-    CVar::vue = glm::lookAt(cam_position,             // Position de la caméra
-                            cam_position + direction, // regarde vers position + direction
-                            cam_up                    // Vecteur "haut"
+    CVar::vue = glm::lookAt(view_position,                 // Position de la caméra
+                            view_position + viewDirection, // regarde vers position + direction
+                            viewUp                         // Vecteur "haut"
     );
 }
 
@@ -818,6 +1329,157 @@ void refreshCamera(GLFWwindow* fenetre, double deltaT)
 //////////////////////////////////////////////////////////
 void compileShaders()
 {
+    // même fonction de hachage du bruit que les requêtes CPU (SeaNoise.h)
+    progNuanceurSea.definir("SEA_NOISE_INT_HASH", std::to_string(SEA_NOISE_INT_HASH));
+    progNuanceurSea.definir("SEA_MAP_LEVELS", std::to_string(SEA_MAP_LEVELS));
+    progNuanceurSea.definir("SEA_GERSTNER_MAX_WAVES", std::to_string(SEA_GERSTNER_MAX_WAVES));
+    progNuanceurSea.definir("SEA_GERSTNER_BINDING", std::to_string(SEA_GERSTNER_BINDING));
+    progNuanceurSea.definir("SEA_CULL_COUNTER", seaCullCounterSupported() ? "1" : "0");
+    progNuanceurSea.definir("SEA_CULL_BINDING", std::to_string(SEA_CULL_BINDING));
+    progNuanceurSea.definir("SEA_TESS_BINDING", std::to_string(SEA_TESS_BINDING));
+
+    // rendu sans tessellation: mêmes vagues, grille fixe par parcelle (SeaCdlod.h)
+    progNuanceurSeaCdlod.definir("SEA_NOISE_INT_HASH", std::to_string(SEA_NOISE_INT_HASH));
+    progNuanceurSeaCdlod.definir("SEA_MAP_LEVELS", std::to_string(SEA_MAP_LEVELS));
+    progNuanceurSeaCdlod.definir("SEA_GERSTNER_MAX_WAVES", std::to_string(SEA_GERSTNER_MAX_WAVES));
+    progNuanceurSeaCdlod.definir("SEA_GERSTNER_BINDING", std::to_string(SEA_GERSTNER_BINDING));
+    progNuanceurSeaCdlod.definir("SEA_CDLOD_GRID", std::to_string(SEA_CDLOD_GRID));
+
+    // anneaux imbriqués (SeaClipmap.h)
+    progNuanceurSeaClipmap.definir("SEA_NOISE_INT_HASH", std::to_string(SEA_NOISE_INT_HASH));
+    progNuanceurSeaClipmap.definir("SEA_MAP_LEVELS", std::to_string(SEA_MAP_LEVELS));
+    progNuanceurSeaClipmap.definir("SEA_GERSTNER_MAX_WAVES", std::to_string(SEA_GERSTNER_MAX_WAVES));
+    progNuanceurSeaClipmap.definir("SEA_GERSTNER_BINDING", std::to_string(SEA_GERSTNER_BINDING));
+    progNuanceurSeaClipmap.definir("SEA_CLIPMAP_BLOCK", std::to_string(SEA_CLIPMAP_BLOCK));
+
     // on compiler ici les programmes de nuanceurs qui furent prédéfinis
     progNuanceurSea.compilerEtLier();
+    progNuanceurSeaCdlod.compilerEtLier();
+    progNuanceurSeaClipmap.compilerEtLier();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///  global public  benchmarkRenderers 
+
+///
+///  Compare le débit des rendus de la mer (tessellation, grille CDLOD, clipmap)
+///  depuis la même caméra, le contrôleur de niveau de détail arrêté. Affiche
+///  le temps par image et les statistiques du pipeline (SeaStats.h).
+///
+///  @param [in]       fenetre GLFWwindow*  fenêtre dont on échange les tampons
+///
+///  @return Aucune
+///////////////////////////////////////////////////////////////////////////////
+void benchmarkRenderers(GLFWwindow* fenetre)
+{
+    const int   images    = 300;
+    const char* noms[4]   = { "tess", "jupes", "cdlod", "clipmap" };
+    const int   rendus[4] = { SEA_RENDER_TESS, SEA_RENDER_TESS, SEA_RENDER_CDLOD, SEA_RENDER_CLIPMAP };
+    bool        lodAuto   = CVar::lodAuto;
+    int         renderer  = CVar::seaRenderer;
+    bool        skirts    = CVar::seaSkirts;
+
+    CVar::lodAuto = false;
+    glfwSwapInterval(0);
+
+    printf("%d images %dx%d, modele de vagues %d\n", images, CVar::currentW, CVar::currentH, CVar::waveModel);
+    printf("%-8s %10s %10s %12s %14s %14s %14s\n", "rendu", "ms/image", "ms CPU", "parcelles", "primitives",
+           "decoupage", "fragments");
+    for (int c = 0; c < 4; c++)
+    {
+        int r             = rendus[c];
+        CVar::seaRenderer = r;
+        CVar::seaSkirts   = c == 1;
+
+        // réchauffement, et assez d'images pour que les requêtes reviennent
+        for (int i = 0; i < SEA_STATS_FRAMES + 30; i++)
+        {
+            drawScene();
+            glfwSwapBuffers(fenetre);
+        }
+        glFinish();
+
+        // temps CPU: drawScene() sans attendre le GPU
+        double debut = glfwGetTime();
+        double cpu   = 0.0;
+        for (int i = 0; i < images; i++)
+        {
+            double t = glfwGetTime();
+            drawScene();
+            cpu += glfwGetTime() - t;
+            glfwSwapBuffers(fenetre);
+            glfwPollEvents();
+        }
+        glFinish();
+        double ms = (glfwGetTime() - debut) * 1000.0 / images;
+        cpu       = cpu * 1000.0 / images;
+
+        const SeaStatsFrame& stats = seaStatsLast();
+        int parcelles = r == SEA_RENDER_CLIPMAP ? seaClipmapBlocks() : surfacePatchesDrawn();
+        printf("%-8s %10.3f %10.3f %12d %14llu %14llu %14llu\n", noms[c], ms, cpu, parcelles,
+               static_cast<unsigned long long>(stats.values[SeaStatPrimitives]),
+               static_cast<unsigned long long>(stats.values[SeaStatClipIn]),
+               static_cast<unsigned long long>(stats.values[SeaStatFragments]));
+    }
+
+    CVar::lodAuto     = lodAuto;
+    CVar::seaRenderer = renderer;
+    CVar::seaSkirts   = skirts;
+    glfwSwapInterval(1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///  @brief Banc d'essai hors écran (--benchmark, voir SeaBench.h): la caméra
+///  suit le chemin chargé, le temps avance de SEA_BENCH_DT par image et le
+///  rapport JSON est écrit dans rapport.
+///////////////////////////////////////////////////////////////////////////////
+bool benchmarkPath(GLFWwindow* fenetre, const char* rapport)
+{
+    const char* noms[3] = { "tess", "cdlod", "clipmap" };
+
+    sceneFramebuffer = seaBenchInit(SEA_BENCH_WIDTH, SEA_BENCH_HEIGHT);
+    if (!sceneFramebuffer)
+        return false;
+    CVar::currentW     = SEA_BENCH_WIDTH;
+    CVar::currentH     = SEA_BENCH_HEIGHT;
+    CVar::mouseControl = false;
+    CVar::lodAuto      = false;
+    // la caméra est posée sur le chemin, refreshCamera() n'en voit pas la
+    // vitesse: le détail ne suit que le chemin, comme dans Bench/BenchGate.cpp
+    CVar::lodMotion    = false;
+
+    int images = static_cast<int>(seaBenchDuration() / SEA_BENCH_DT) + 1;
+    printf("Banc d'essai: %d images %dx%d, rendu %s\n", images, SEA_BENCH_WIDTH, SEA_BENCH_HEIGHT,
+           noms[CVar::seaRenderer]);
+
+    // réchauffement au début du chemin, puis une image par pas de temps
+    for (int i = -SEA_BENCH_WARMUP; i < images; i++)
+    {
+        double         t      = std::max(i, 0) * SEA_BENCH_DT;
+        SeaBenchCamera camera = seaBenchCamera(t);
+        CVar::temps           = t;
+        prev_cam_position     = cam_position;
+        cam_position          = camera.position;
+        horizontalAngle       = camera.horizontalAngle;
+        verticalAngle         = camera.verticalAngle;
+        refreshCamera(fenetre, SEA_BENCH_DT, 1.0);
+        refreshView(1.0);
+
+        if (i >= 0)
+            seaBenchBeginFrame();
+        double debut = glfwGetTime();
+        drawScene();
+        double cpu = (glfwGetTime() - debut) * 1000.0;
+        seaMemFrame();
+        if (i >= 0)
+            seaBenchEndFrame(cpu, CVar::seaRenderer == SEA_RENDER_CLIPMAP ? seaClipmapBlocks() : surfacePatchesDrawn());
+        seaProfileFrame();
+    }
+
+    bool ok = seaBenchWriteJson(rapport, noms[CVar::seaRenderer]);
+    if (ok)
+        printf("Rapport ecrit dans %s\n", rapport);
+    seaBenchShutdown();
+    sceneFramebuffer = 0;
+    return ok;
 }